@@ -7,6 +7,10 @@ pkg_check_modules(XRANDR REQUIRED xrandr)
 pkg_check_modules(XINERAMA xinerama)
 pkg_check_modules(XEXT REQUIRED xext)
 
+# for sending several requests at once without waiting for each reply (optional)
+pkg_check_modules(X11XCB x11-xcb)
+pkg_check_modules(XCB xcb)
+
 # for transparency support
 pkg_check_modules(XRENDER REQUIRED xrender)
 
@@ -14,4 +18,7 @@ pkg_check_modules(XRENDER REQUIRED xrender)
 pkg_check_modules(XFT REQUIRED xft)
 pkg_check_modules(FREETYPE REQUIRED freetype2)
 
+# for faster regular expressions (optional)
+pkg_check_modules(RE2 re2)
+
 # vim: et:ts=4:sw=4
@@ -3,7 +3,7 @@
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
-#include <stdio.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -40,12 +40,15 @@ char** argv_duplicate(int argc, char** argv) {
     }
     char** new_argv = malloc(sizeof(char*) * argc);
     if (!new_argv) {
-        fprintf(stderr, "cannot malloc - there is no memory available\n");
-        exit(EXIT_FAILURE);
+        return NULL;
     }
     int i;
     for (i = 0; i < argc; i++) {
         new_argv[i] = strdup(argv[i]);
+        if (!new_argv[i]) {
+            argv_free(i, new_argv);
+            return NULL;
+        }
     }
     return new_argv;
 }
@@ -61,3 +64,65 @@ void argv_free(int argc, char** argv) {
     }
     free(argv);
 }
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool argv_split(const char* str, int* ret_argc, char*** ret_argv) {
+    int argc = 0;
+    char** argv = NULL;
+    // no argument is longer than the entire string
+    char* buf = malloc(strlen(str) + 1);
+    if (!buf) {
+        errno = ENOMEM;
+        return false;
+    }
+    const char* pos = str;
+    while (true) {
+        while (is_blank(*pos)) {
+            pos++;
+        }
+        if (*pos == '\0' || *pos == '#') {
+            break;
+        }
+        size_t len = 0;
+        char quote = '\0'; // the currently open quote, if any
+        for (; *pos && (quote || !is_blank(*pos)); pos++) {
+            if (quote == '\'' && *pos != '\'') {
+                buf[len++] = *pos;
+            } else if (*pos == quote) {
+                quote = '\0';
+            } else if (!quote && (*pos == '\'' || *pos == '"')) {
+                quote = *pos;
+            } else if (*pos == '\\' && pos[1]
+                       && (!quote || pos[1] == '"' || pos[1] == '\\')) {
+                pos++;
+                buf[len++] = *pos;
+            } else {
+                buf[len++] = *pos;
+            }
+        }
+        if (quote) {
+            free(buf);
+            argv_free(argc, argv);
+            errno = EINVAL;
+            return false;
+        }
+        char** new_argv = realloc(argv, sizeof(char*) * (argc + 1));
+        buf[len] = '\0';
+        char* arg = new_argv ? strdup(buf) : NULL;
+        if (!arg) {
+            free(buf);
+            argv_free(argc, new_argv ? new_argv : argv);
+            errno = ENOMEM;
+            return false;
+        }
+        argv = new_argv;
+        argv[argc++] = arg;
+    }
+    free(buf);
+    *ret_argc = argc;
+    *ret_argv = argv;
+    return true;
+}
@@ -3,11 +3,25 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <stdbool.h>
+
+// These helpers are linked into libherbstclient, but they are not part
+// of its interface, so they must not clash with symbols of its users.
+#pragma GCC visibility push(hidden)
 
 // return a window property or NULL on error
 char* read_window_property(Display* dpy, Window window, Atom atom);
+// returns NULL if there is no memory available
 char** argv_duplicate(int argc, char** argv);
 void argv_free(int argc, char** argv);
+// split a command into its arguments like a posix shell does, i.e. at
+// unquoted whitespace, removing quotes and backslashes. A '#' at the
+// beginning of an argument starts a comment. Returns false and sets errno
+// to EINVAL on unmatched quotes resp. to ENOMEM if there is no memory
+// available; on success, the argument-vector has to be freed by the caller.
+bool argv_split(const char* str, int* ret_argc, char*** ret_argv);
+
+#pragma GCC visibility pop
 
 
 #endif
@@ -7,15 +7,26 @@
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <arpa/inet.h>
+#include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include "../src/ipc-protocol.h"
 #include "client-utils.h"
 #include "ipc-client.h"
 
+typedef struct {
+    HCReplyCallback callback;
+    void*           user_data;
+} HCPendingRequest;
+
 struct HCConnection {
     Display*    display;
     bool        own_display; // if we have to close it on disconnect
@@ -25,6 +36,21 @@ struct HCConnection {
     Atom        atom_output;
     Atom        atom_status;
     Window      root;
+    int         socket_fd; // -1 if commands are sent via X
+    bool        subscribed; // whether socket_fd is a hook stream
+    unsigned long long hook_sequence; // of the last hook on the stream
+    unsigned long long hooks_missed; // since the last hc_hooks_missed()
+    char*       read_buffer; // bytes received on socket_fd
+    size_t      read_start; // the bytes before have been parsed already
+    size_t      read_length;
+    size_t      read_capacity;
+    HCPendingRequest* pending; // ring buffer of the async requests
+                               // waiting for their reply
+    size_t      pending_begin; // index of the oldest request
+    size_t      pending_count;
+    size_t      pending_capacity;
+    HCHookCallback hook_callback;
+    void*       hook_user_data;
 };
 
 HCConnection* hc_connect() {
@@ -45,6 +71,7 @@ HCConnection* hc_connect_to_display(Display* display) {
         return con;
     }
     memset(con, 0, sizeof(HCConnection));
+    con->socket_fd = -1;
     con->display = display;
     con->root = DefaultRootWindow(con->display);
     con->atom_args = XInternAtom(con->display, HERBST_IPC_ARGS_ATOM, False);
@@ -53,16 +80,94 @@ HCConnection* hc_connect_to_display(Display* display) {
     return con;
 }
 
+char* hc_socket_path(const char* display_name) {
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (!runtime_dir || !runtime_dir[0]) {
+        return NULL;
+    }
+    if (!display_name) {
+        display_name = getenv("DISPLAY");
+    }
+    if (!display_name) {
+        return NULL;
+    }
+    // same as IpcSocketServer::socketPath(): drop the screen number
+    // and replace every '/' by '_'
+    char* display = strdup(display_name);
+    if (!display) {
+        return NULL;
+    }
+    char* colon = strrchr(display, ':');
+    if (colon) {
+        char* dot = strchr(colon, '.');
+        if (dot) {
+            *dot = '\0';
+        }
+    }
+    for (char* c = display; *c; c++) {
+        if (*c == '/') {
+            *c = '_';
+        }
+    }
+    size_t len = strlen(runtime_dir) + strlen(display)
+        + sizeof("/" HERBST_IPC_SOCKET_DIR "/" HERBST_IPC_SOCKET_PREFIX);
+    char* path = malloc(len);
+    if (path) {
+        snprintf(path, len, "%s/" HERBST_IPC_SOCKET_DIR "/"
+                 HERBST_IPC_SOCKET_PREFIX "%s", runtime_dir, display);
+    }
+    free(display);
+    return path;
+}
+
+HCConnection* hc_connect_socket() {
+    char* path = hc_socket_path(NULL);
+    if (!path) {
+        return NULL;
+    }
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        free(path);
+        return NULL;
+    }
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    free(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        // there is no herbstluftwm listening on the socket
+        close(fd);
+        return NULL;
+    }
+    HCConnection* con = malloc(sizeof(struct HCConnection));
+    if (!con) {
+        close(fd);
+        return NULL;
+    }
+    memset(con, 0, sizeof(HCConnection));
+    con->socket_fd = fd;
+    return con;
+}
+
 void hc_disconnect(HCConnection* con) {
     if (!con) {
         return;
     }
+    if (con->socket_fd >= 0) {
+        close(con->socket_fd);
+    }
     if (con->client_window) {
         XDestroyWindow(con->display, con->client_window);
     }
-    if (con->own_display) {
+    if (con->own_display && con->display) {
         XCloseDisplay(con->display);
     }
+    free(con->read_buffer);
+    free(con->pending);
     free(con);
 }
 
@@ -89,8 +194,275 @@ bool hc_create_client_window(HCConnection* con) {
     return true;
 }
 
+static bool write_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t size = send(fd, buf, len, MSG_NOSIGNAL);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size <= 0) {
+            return false;
+        }
+        buf += size;
+        len -= (size_t)size;
+    }
+    return true;
+}
+
+/* whether the error only says that the operation would block. On most
+ * systems, EWOULDBLOCK is just another name for EAGAIN. */
+static bool would_block(int error) {
+#if EAGAIN == EWOULDBLOCK
+    return error == EAGAIN;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+}
+
+/* read the available bytes from the socket into the read buffer. Returns 1
+ * if bytes were read, 0 if none are available without blocking, and -1 on
+ * EOF or an error. */
+static int fill_buffer(HCConnection* con, bool block) {
+    const size_t chunk = 4096;
+    if (con->read_start > 0 && con->read_capacity - con->read_length < chunk) {
+        // reuse the space of the messages that were parsed already
+        memmove(con->read_buffer, con->read_buffer + con->read_start,
+                con->read_length - con->read_start);
+        con->read_length -= con->read_start;
+        con->read_start = 0;
+    }
+    if (con->read_capacity - con->read_length < chunk) {
+        size_t capacity = con->read_capacity ? 2 * con->read_capacity : 4 * chunk;
+        char* buffer = realloc(con->read_buffer, capacity);
+        if (!buffer) {
+            return -1;
+        }
+        con->read_buffer = buffer;
+        con->read_capacity = capacity;
+    }
+    while (true) {
+        ssize_t size = recv(con->socket_fd, con->read_buffer + con->read_length,
+                            con->read_capacity - con->read_length,
+                            block ? 0 : MSG_DONTWAIT);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size < 0 && !block && would_block(errno)) {
+            return 0;
+        }
+        if (size <= 0) {
+            return -1;
+        }
+        con->read_length += (size_t)size;
+        return 1;
+    }
+}
+
+/* take the payload of the next message from the read buffer, receiving more
+ * bytes if necessary. Returns 1 if 'ret_payload' was set (it is
+ * null-terminated and has to be freed by the caller), 0 if there is no
+ * complete message yet and 'block' is false, and -1 on EOF or if the message
+ * is malformed. */
+static int next_message(HCConnection* con, bool block,
+                        char** ret_payload, size_t* ret_length) {
+    while (true) {
+        size_t available = con->read_length - con->read_start;
+        uint32_t length;
+        if (available >= sizeof(length)) {
+            char* message = con->read_buffer + con->read_start;
+            memcpy(&length, message, sizeof(length));
+            length = ntohl(length);
+            if (length > HERBST_IPC_SOCKET_MAX_MESSAGE) {
+                return -1;
+            }
+            if (available >= sizeof(length) + length) {
+                char* payload = malloc(length + 1);
+                if (!payload) {
+                    return -1;
+                }
+                memcpy(payload, message + sizeof(length), length);
+                payload[length] = '\0';
+                con->read_start += sizeof(length) + length;
+                if (con->read_start == con->read_length) {
+                    con->read_start = con->read_length = 0;
+                }
+                *ret_payload = payload;
+                *ret_length = length;
+                return 1;
+            }
+        }
+        int result = fill_buffer(con, block);
+        if (result <= 0) {
+            return result;
+        }
+    }
+}
+
+/* split the payload of a reply into the status and the output. The output
+ * reuses the memory of the payload. */
+static bool parse_reply(char* payload, size_t length,
+                        char** ret_out, int* ret_status) {
+    int32_t status;
+    if (length < sizeof(status)) {
+        return false;
+    }
+    memcpy(&status, payload, sizeof(status));
+    memmove(payload, payload + sizeof(status), length - sizeof(status) + 1);
+    *ret_status = (int32_t)ntohl((uint32_t)status);
+    *ret_out = payload;
+    return true;
+}
+
+/* split the payload of a hook message into its sequence number and its
+ * null-terminated arguments. A hook with zero arguments tells how many hooks
+ * were lost. */
+static bool parse_hook(const char* payload, size_t length,
+                       unsigned long long* ret_sequence,
+                       int* ret_argc, char** ret_argv[]) {
+    uint32_t sequence[2];
+    if (length < sizeof(sequence)) {
+        return false;
+    }
+    memcpy(sequence, payload, sizeof(sequence));
+    *ret_sequence = ((unsigned long long)ntohl(sequence[0]) << 32)
+                    | ntohl(sequence[1]);
+    const char* args = payload + sizeof(sequence);
+    size_t args_len = length - sizeof(sequence);
+    int argc = 0;
+    for (size_t i = 0; i < args_len; i++) {
+        if (args[i] == '\0') {
+            argc++;
+        }
+    }
+    char** argv = malloc(sizeof(char*) * (argc > 0 ? argc : 1));
+    if (!argv) {
+        return false;
+    }
+    for (int i = 0; i < argc; i++) {
+        argv[i] = strdup(args);
+        args += strlen(args) + 1;
+    }
+    *ret_argc = argc;
+    *ret_argv = argv;
+    return true;
+}
+
+/* handle a message that was received outside of hc_read_reply() and
+ * hc_next_hook(): on a hook stream it is passed to the hook callback,
+ * otherwise it is the reply to the oldest async request. */
+static bool dispatch_message(HCConnection* con, char* payload, size_t length) {
+    if (con->subscribed) {
+        unsigned long long sequence;
+        int argc;
+        char** argv;
+        bool success = parse_hook(payload, length, &sequence, &argc, &argv);
+        free(payload);
+        if (!success) {
+            return false;
+        }
+        if (argc == 0) {
+            con->hooks_missed += sequence;
+        } else {
+            con->hook_sequence = sequence;
+            if (con->hook_callback) {
+                con->hook_callback(argc, argv, sequence, con->hook_user_data);
+            }
+        }
+        argv_free(argc, argv);
+        return true;
+    }
+    if (con->pending_count == 0) {
+        // a reply that nobody has asked for
+        free(payload);
+        return false;
+    }
+    // remove the request before running its callback, such that the
+    // callback can send new requests
+    HCPendingRequest request = con->pending[con->pending_begin];
+    con->pending_begin = (con->pending_begin + 1) % con->pending_capacity;
+    con->pending_count--;
+    char* output;
+    int status;
+    if (!parse_reply(payload, length, &output, &status)) {
+        free(payload);
+        return false;
+    }
+    if (request.callback) {
+        request.callback(status, output, request.user_data);
+    }
+    free(output);
+    return true;
+}
+
+/* wait until the replies to all async requests have been received */
+static bool wait_for_pending(HCConnection* con) {
+    while (con->pending_count > 0) {
+        char* payload;
+        size_t length;
+        if (next_message(con, true, &payload, &length) < 0
+            || !dispatch_message(con, payload, length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hc_is_socket(HCConnection* con) {
+    return con->socket_fd >= 0;
+}
+
+bool hc_send_request(HCConnection* con, int argc, char* argv[]) {
+    if (con->socket_fd < 0) {
+        return false;
+    }
+    // the framing is described in ipc-protocol.h
+    size_t length = 0;
+    for (int i = 0; i < argc; i++) {
+        length += strlen(argv[i]) + 1;
+    }
+    if (length > HERBST_IPC_SOCKET_MAX_MESSAGE) {
+        return false;
+    }
+    char* message = malloc(sizeof(uint32_t) + length);
+    if (!message) {
+        return false;
+    }
+    uint32_t header = htonl((uint32_t)length);
+    memcpy(message, &header, sizeof(header));
+    char* pos = message + sizeof(header);
+    for (int i = 0; i < argc; i++) {
+        size_t arg_len = strlen(argv[i]) + 1;
+        memcpy(pos, argv[i], arg_len);
+        pos += arg_len;
+    }
+    bool success = write_all(con->socket_fd, message, sizeof(header) + length);
+    free(message);
+    return success;
+}
+
+bool hc_read_reply(HCConnection* con, char** ret_out, int* ret_status) {
+    if (con->socket_fd < 0) {
+        return false;
+    }
+    char* payload;
+    size_t length;
+    if (next_message(con, true, &payload, &length) < 0) {
+        return false;
+    }
+    if (!parse_reply(payload, length, ret_out, ret_status)) {
+        free(payload);
+        return false;
+    }
+    return true;
+}
+
 bool hc_send_command(HCConnection* con, int argc, char* argv[],
                      char** ret_out, int* ret_status) {
+    if (con->socket_fd >= 0) {
+        return wait_for_pending(con)
+            && hc_send_request(con, argc, argv)
+            && hc_read_reply(con, ret_out, ret_status);
+    }
     if (!hc_create_client_window(con)) {
         return false;
     }
@@ -191,7 +563,100 @@ static Window get_hook_window(Display* display) {
     return win;
 }
 
+bool hc_subscribe_hooks(HCConnection* con, const char* since,
+                        int filter_count, char* filter[],
+                        unsigned long long* next_sequence,
+                        char** ret_error) {
+    if (ret_error) {
+        *ret_error = NULL;
+    }
+    if (con->socket_fd < 0 || con->subscribed) {
+        return false;
+    }
+    if (!wait_for_pending(con)) {
+        return false;
+    }
+    // the format of this control request is described in ipc-protocol.h
+    char** argv = malloc(sizeof(char*) * (3 + filter_count));
+    if (!argv) {
+        return false;
+    }
+    argv[0] = "";
+    argv[1] = HERBST_IPC_SOCKET_SUBSCRIBE;
+    argv[2] = since ? (char*)since : "";
+    for (int i = 0; i < filter_count; i++) {
+        argv[3 + i] = filter[i];
+    }
+    char* output;
+    int status;
+    bool success = hc_send_request(con, 3 + filter_count, argv)
+        && hc_read_reply(con, &output, &status);
+    free(argv);
+    if (!success) {
+        return false;
+    }
+    if (status != 0) {
+        if (ret_error) {
+            *ret_error = output;
+        } else {
+            free(output);
+        }
+        return false;
+    }
+    if (next_sequence) {
+        *next_sequence = strtoull(output, NULL, 10);
+    }
+    free(output);
+    con->subscribed = true;
+    return true;
+}
+
+unsigned long long hc_hook_sequence(HCConnection* con) {
+    return con->hook_sequence;
+}
+
+unsigned long long hc_hooks_missed(HCConnection* con) {
+    unsigned long long missed = con->hooks_missed;
+    con->hooks_missed = 0;
+    return missed;
+}
+
+static bool next_socket_hook(HCConnection* con, int* ret_argc, char** ret_argv[]) {
+    if (!con->subscribed && !hc_subscribe_hooks(con, NULL, 0, NULL, NULL, NULL)) {
+        return false;
+    }
+    while (true) {
+        char* payload;
+        size_t length;
+        if (next_message(con, true, &payload, &length) < 0) {
+            // herbstluftwm has quit
+            return false;
+        }
+        unsigned long long sequence;
+        int argc;
+        char** argv;
+        bool success = parse_hook(payload, length, &sequence, &argc, &argv);
+        free(payload);
+        if (!success) {
+            return false;
+        }
+        if (argc > 0) {
+            con->hook_sequence = sequence;
+            *ret_argc = argc;
+            *ret_argv = argv;
+            return true;
+        }
+        // a message without arguments tells how many hooks were lost
+        con->hooks_missed += sequence;
+        free(argv);
+    }
+}
+
 bool hc_check_running(HCConnection* con) {
+    if (con->socket_fd >= 0) {
+        // connect() only succeeds if herbstluftwm listens on the socket
+        return true;
+    }
     return get_hook_window(con->display) != 0;
 }
 
@@ -208,53 +673,171 @@ bool hc_hook_window_connect(HCConnection* con) {
     return true;
 }
 
+/* handle an event on the hook window. Returns 1 if it carried a hook, 0 if
+ * the event is to be ignored and -1 if the hook window was destroyed or if
+ * there is no memory available. */
+static int handle_hook_event(HCConnection* con, XEvent* event,
+                             int* argc, char** argv[]) {
+    Window win = con->hook_window;
+    if (event->type == DestroyNotify) {
+        if (event->xdestroywindow.window == win) {
+            // hook window was destroyed
+            // so quit idling
+            return -1;
+        }
+    }
+    if (event->type != PropertyNotify) {
+        fprintf(stderr, "Warning: got other event than PropertyNotify\n");
+        return 0;
+    }
+    XPropertyEvent* pe = &event->xproperty;
+    if (pe->state == PropertyDelete) {
+        // just ignore property delete events
+        return 0;
+    }
+    if (pe->window != win) {
+        fprintf(stderr, "Warning: expected event from window %u", (unsigned int)win);
+        fprintf(stderr, " but got something from %u\n", (unsigned int)pe->window);
+        return 0;
+    }
+    XTextProperty text_prop;
+    XGetTextProperty(con->display, win, &text_prop, pe->atom);
+    char** list_return;
+    int count;
+    if (Success != Xutf8TextPropertyToTextList(con->display, &text_prop,
+                                               &list_return, &count)) {
+        XFree(text_prop.value);
+        return -1;
+    }
+    *argc = count;
+    *argv = argv_duplicate(count, list_return); // has to be freed by caller
+    // cleanup
+    XFreeStringList(list_return);
+    XFree(text_prop.value);
+    if (count > 0 && !*argv) {
+        // there is no memory available
+        return -1;
+    }
+    return 1;
+}
+
 bool hc_next_hook(HCConnection* con, int* argc, char** argv[]) {
+    if (con->socket_fd >= 0) {
+        return next_socket_hook(con, argc, argv);
+    }
     if (!hc_hook_window_connect(con)) {
         return false;
     }
-    // get window to listen at
-    Window win = con->hook_window;
     // listen on window
     XEvent next_event;
-    bool received_hook = false;
-    while (!received_hook) {
+    while (true) {
         XNextEvent(con->display, &next_event);
-        if (next_event.type == DestroyNotify) {
-            if (next_event.xdestroywindow.window == win) {
-                // hook window was destroyed
-                // so quit idling
-                return false;
-            }
+        int result = handle_hook_event(con, &next_event, argc, argv);
+        if (result != 0) {
+            return result > 0;
         }
-        if (next_event.type != PropertyNotify) {
-            fprintf(stderr, "Warning: got other event than PropertyNotify\n");
-            continue;
+    }
+}
+
+/* double the capacity of the ring buffer of pending requests, which must
+ * be full */
+static bool grow_pending(HCConnection* con) {
+    size_t old_capacity = con->pending_capacity;
+    size_t capacity = old_capacity ? 2 * old_capacity : 16;
+    HCPendingRequest* pending =
+        realloc(con->pending, sizeof(HCPendingRequest) * capacity);
+    if (!pending) {
+        return false;
+    }
+    // the requests before pending_begin were wrapped around to the front,
+    // so move them behind the requests from pending_begin on
+    memcpy(pending + old_capacity, pending,
+           sizeof(HCPendingRequest) * con->pending_begin);
+    con->pending = pending;
+    con->pending_capacity = capacity;
+    return true;
+}
+
+bool hc_send_command_async(HCConnection* con, int argc, char* argv[],
+                           HCReplyCallback callback, void* user_data) {
+    if (con->socket_fd < 0) {
+        // via X, there can only be one command at a time
+        char* output;
+        int status;
+        if (!hc_send_command(con, argc, argv, &output, &status)) {
+            return false;
         }
-        XPropertyEvent* pe = &next_event.xproperty;
-        if (pe->state == PropertyDelete) {
-            // just ignore property delete events
-            continue;
+        if (callback) {
+            callback(status, output, user_data);
         }
-        if (pe->window != win) {
-            fprintf(stderr, "Warning: expected event from window %u", (unsigned int)win);
-            fprintf(stderr, " but got something from %u\n", (unsigned int)pe->window);
+        free(output);
+        return true;
+    }
+    if (con->subscribed) {
+        return false;
+    }
+    if (con->pending_count == con->pending_capacity && !grow_pending(con)) {
+        return false;
+    }
+    if (!hc_send_request(con, argc, argv)) {
+        return false;
+    }
+    size_t end = (con->pending_begin + con->pending_count) % con->pending_capacity;
+    con->pending[end].callback = callback;
+    con->pending[end].user_data = user_data;
+    con->pending_count++;
+    return true;
+}
+
+int hc_pending(HCConnection* con) {
+    return (int)con->pending_count;
+}
+
+int hc_fd(HCConnection* con) {
+    if (con->socket_fd >= 0) {
+        return con->socket_fd;
+    }
+    return ConnectionNumber(con->display);
+}
+
+void hc_set_hook_callback(HCConnection* con, HCHookCallback callback,
+                          void* user_data) {
+    con->hook_callback = callback;
+    con->hook_user_data = user_data;
+}
+
+bool hc_dispatch(HCConnection* con) {
+    if (con->socket_fd >= 0) {
+        while (true) {
+            char* payload;
+            size_t length;
+            int result = next_message(con, false, &payload, &length);
+            if (result == 0) {
+                return true;
+            }
+            if (result < 0 || !dispatch_message(con, payload, length)) {
+                return false;
+            }
+        }
+    }
+    while (XPending(con->display)) {
+        XEvent event;
+        XNextEvent(con->display, &event);
+        if (!con->hook_window) {
             continue;
         }
-        XTextProperty text_prop;
-        XGetTextProperty(con->display, win, &text_prop, pe->atom);
-        char** list_return;
-        int count;
-        if (Success != Xutf8TextPropertyToTextList(con->display, &text_prop,
-                                                   &list_return, &count)) {
-            XFree(text_prop.value);
+        int argc;
+        char** argv;
+        int result = handle_hook_event(con, &event, &argc, &argv);
+        if (result < 0) {
             return false;
         }
-        *argc = count;
-        *argv = argv_duplicate(count, list_return); // has to be freed by caller
-        received_hook = true;
-        // cleanup
-        XFreeStringList(list_return);
-        XFree(text_prop.value);
+        if (result > 0) {
+            if (con->hook_callback) {
+                con->hook_callback(argc, argv, 0, con->hook_user_data);
+            }
+            argv_free(argc, argv);
+        }
     }
     return true;
 }
@@ -6,9 +6,18 @@
 #include <X11/Xlib.h>
 #include <stdbool.h>
 
+#include "ipc-exit-status.h"
+
 #ifndef __HERBSTLUFT_IPC_CLIENT_H_
 #define __HERBSTLUFT_IPC_CLIENT_H_
 
+/* This header is installed as <herbstluftwm/ipc-client.h>, for programs
+ * linking against libherbstclient instead of running herbstclient. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct HCConnection HCConnection;
 
 /** Connect to hlwm via an X11 display. This does not check whether
@@ -16,6 +25,14 @@ typedef struct HCConnection HCConnection;
  */
 HCConnection* hc_connect();
 HCConnection* hc_connect_to_display(Display* display);
+/** Connect to hlwm via its unix socket. Returns NULL if there is no
+ * herbstluftwm listening on the socket.
+ */
+HCConnection* hc_connect_socket();
+/** the path of the unix socket for the given display name, or for
+ * $DISPLAY if it is NULL. The result has to be freed by the caller.
+ */
+char* hc_socket_path(const char* display_name);
 /** check whether herbstluftwm is running */
 bool hc_check_running(HCConnection* con);
 void hc_disconnect(HCConnection* con);
@@ -23,11 +40,69 @@ void hc_disconnect(HCConnection* con);
 /* ensure there is a client window for sending commands */
 bool hc_create_client_window(HCConnection* con);
 
+/* the status is one of the HERBST_* exit codes from ipc-exit-status.h */
 bool hc_send_command(HCConnection* con, int argc, char* argv[],
                      char** ret_out, int* ret_status);
+/* on a socket connection, a request can be sent without waiting for the
+ * reply of the previous request. The replies arrive in the same order as
+ * the requests. */
+bool hc_is_socket(HCConnection* con);
+bool hc_send_request(HCConnection* con, int argc, char* argv[]);
+bool hc_read_reply(HCConnection* con, char** ret_out, int* ret_status);
 
 bool hc_hook_window_connect(HCConnection* con);
+/* turn a socket connection into a hook stream. If 'since' is not NULL, the
+ * stream starts with the hooks since this sequence number that are still in
+ * the backlog of the server. The server only sends the hooks whose n'th
+ * argument matches the n'th regex in 'filter'. 'next_sequence' is set to the
+ * sequence number of the next hook that is emitted. If the server rejects
+ * the subscription, e.g. because of an invalid filter, and 'ret_error' is
+ * not NULL, then it is set to the error message, which has to be freed by
+ * the caller. */
+bool hc_subscribe_hooks(HCConnection* con, const char* since,
+                        int filter_count, char* filter[],
+                        unsigned long long* next_sequence,
+                        char** ret_error);
 bool hc_next_hook(HCConnection* con, int* argc, char** argv[]);
+/* the sequence number of the hook last returned by hc_next_hook() on a
+ * socket connection. Via X, hooks have no sequence numbers. */
+unsigned long long hc_hook_sequence(HCConnection* con);
+/* the number of hooks lost on the hook stream since the last call */
+unsigned long long hc_hooks_missed(HCConnection* con);
+
+/* Asynchronous usage: the callbacks are run from within hc_dispatch(), which
+ * handles everything that can be read from hc_fd() without blocking. So a
+ * program with its own main loop polls hc_fd() for reading and calls
+ * hc_dispatch() whenever it is readable. The 'output' and 'argv' passed to
+ * the callbacks are freed when the callbacks return. */
+typedef void (*HCReplyCallback)(int status, const char* output,
+                                void* user_data);
+typedef void (*HCHookCallback)(int argc, char** argv,
+                               unsigned long long sequence, void* user_data);
+/* send a command without waiting for its reply. On a socket connection,
+ * arbitrarily many commands can be in flight and their callbacks are run
+ * in the order of the commands. Via X, the command is executed
+ * synchronously and the callback is run before this returns. */
+bool hc_send_command_async(HCConnection* con, int argc, char* argv[],
+                           HCReplyCallback callback, void* user_data);
+/* the number of async commands whose reply has not arrived yet */
+int hc_pending(HCConnection* con);
+/* the file descriptor to poll for reading */
+int hc_fd(HCConnection* con);
+/* set the callback for the hooks received by hc_dispatch(). The connection
+ * must be turned into a hook stream first by hc_subscribe_hooks() resp.
+ * hc_hook_window_connect(). A socket connection that is a hook stream
+ * cannot send commands anymore, so use two connections for both. */
+void hc_set_hook_callback(HCConnection* con, HCHookCallback callback,
+                          void* user_data);
+/* run the callbacks for all replies and hooks that are available without
+ * blocking. Returns false if the connection is broken, e.g. because
+ * herbstluftwm has quit. */
+bool hc_dispatch(HCConnection* con);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
 
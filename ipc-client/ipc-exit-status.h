@@ -0,0 +1,20 @@
+#ifndef __HERBST_IPC_EXIT_STATUS_H_
+#define __HERBST_IPC_EXIT_STATUS_H_
+
+/* The exit status of a command in herbstluftwm. This header is installed as
+ * <herbstluftwm/ipc-exit-status.h>, such that the users of libherbstclient
+ * can interpret the status of the replies. */
+enum {
+    HERBST_EXIT_SUCCESS = 0,
+    HERBST_UNKNOWN_ERROR,
+    HERBST_COMMAND_NOT_FOUND,
+    HERBST_INVALID_ARGUMENT,
+    HERBST_SETTING_NOT_FOUND,
+    HERBST_TAG_IN_USE,
+    HERBST_FORBIDDEN,
+    HERBST_NO_PARAMETER_EXPECTED,
+    HERBST_ENV_UNSET,
+    HERBST_NEED_MORE_ARGS,
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include <X11/Xlib.h>
 #include <assert.h>
+#include <errno.h>
 #include <getopt.h>
 #include <regex.h>
 #include <signal.h>
@@ -15,11 +16,15 @@
 static void print_help(char* command, FILE* file);
 static void init_hook_regex(int argc, char* argv[]);
 static void destroy_hook_regex();
+static void print_output(const char* output, int command_status);
 
 static int g_ensure_newline = 1; // if set, output ends with a newline
 static bool g_null_char_as_delim = false; // if true, the null character is used as delimiter
 static bool g_print_last_arg_only = false; // if true, prints only the last argument of a hook
 static int g_wait_for_hook = 0; // if set, do not execute command but wait
+static bool g_batch = false; // if true, read the commands from files or stdin
+static bool g_print_sequence = false; // if true, print the sequence number of hooks
+static char* g_resume_since = NULL; // the sequence number to resume hooks from
 static bool g_quiet = false;
 static regex_t* g_hook_regex = NULL;
 static int g_hook_regex_count = 0;
@@ -69,8 +74,9 @@ void print_help(char* command, FILE* file) {
 
     fprintf(file,
         "Usage: %s [OPTIONS] COMMAND [ARGS ...]\n"
-        "       %s [OPTIONS] [--wait|--idle] [FILTER ...]\n",
-        command, command);
+        "       %s [OPTIONS] [--wait|--idle] [FILTER ...]\n"
+        "       %s [OPTIONS] --batch [FILE ...]\n",
+        command, command, command);
 
     char* help_string =
         "Send a COMMAND with optional arguments ARGS to a running "
@@ -79,12 +85,18 @@ void print_help(char* command, FILE* file) {
         "\t-n, --no-newline: Do not print a newline if output does not end "
             "with a newline.\n"
         "\t-0, --print0: Use the null character as delimiter between the "
-            "output of hooks.\n"
+            "output of hooks and between the commands and replies of "
+            "--batch.\n"
         "\t-l, --last-arg: Print only the last argument of a hook.\n"
         "\t-i, --idle: Wait for hooks instead of executing commands.\n"
         "\t-w, --wait: Same as --idle but exit after first --count hooks.\n"
         "\t-c, --count COUNT: Let --wait exit after COUNT hooks were "
             "received and printed. The default of COUNT is 1.\n"
+        "\t-s, --sequence: Print the sequence number of every hook.\n"
+        "\t-r, --resume SEQ: Let --idle and --wait start with the hooks "
+            "since the sequence number SEQ.\n"
+        "\t-b, --batch: Read commands from the FILEs or stdin, one per "
+            "line, and send them all over a single connection.\n"
         "\t-q, --quiet: Do not print error messages if herbstclient cannot "
             "connect to the running herbstluftwm instance.\n"
         "\t-v, --version: Print the herbstclient version. To get the "
@@ -97,23 +109,51 @@ void print_help(char* command, FILE* file) {
 
 int main_hook(int argc, char* argv[]) {
     init_hook_regex(argc, argv);
-    Display* display = XOpenDisplay(NULL);
-    if (!display) {
-        if (!g_quiet) {
-            fprintf(stderr, "Error: Cannot open display\n");
+    // prefer the hook stream on the unix socket, which does not lose hooks
+    // and filters the hooks on the server side
+    Display* display = NULL;
+    HCConnection* con = hc_connect_socket();
+    if (con) {
+        char* error = NULL;
+        if (!hc_subscribe_hooks(con, g_resume_since, argc, argv, NULL, &error)) {
+            if (!g_quiet) {
+                if (error) {
+                    fputs(error, stderr);
+                }
+                fprintf(stderr, "Error: Cannot subscribe to hooks\n");
+            }
+            free(error);
+            hc_disconnect(con);
+            destroy_hook_regex();
+            return EXIT_FAILURE;
         }
-        destroy_hook_regex();
-        return EXIT_FAILURE;
-    }
-    HCConnection* con = hc_connect_to_display(display);
-    if (!hc_check_running(con)) {
+    } else if (g_print_sequence || g_resume_since) {
         if (!g_quiet) {
-            fprintf(stderr, "Error: herbstluftwm is not running\n");
+            fprintf(stderr, "Error: Cannot connect to the unix socket of "
+                            "herbstluftwm, which is required for "
+                            "--sequence and --resume\n");
         }
-        hc_disconnect(con);
-        XCloseDisplay(display);
         destroy_hook_regex();
         return EXIT_FAILURE;
+    } else {
+        display = XOpenDisplay(NULL);
+        if (!display) {
+            if (!g_quiet) {
+                fprintf(stderr, "Error: Cannot open display\n");
+            }
+            destroy_hook_regex();
+            return EXIT_FAILURE;
+        }
+        con = hc_connect_to_display(display);
+        if (!hc_check_running(con)) {
+            if (!g_quiet) {
+                fprintf(stderr, "Error: herbstluftwm is not running\n");
+            }
+            hc_disconnect(con);
+            XCloseDisplay(display);
+            destroy_hook_regex();
+            return EXIT_FAILURE;
+        }
     }
     signal(SIGTERM, quit_herbstclient);
     signal(SIGINT,  quit_herbstclient);
@@ -130,7 +170,16 @@ int main_hook(int argc, char* argv[]) {
             // returning
             break;
         }
-        for (int i = 0; i < argc && i < hook_argc; i++) {
+        unsigned long long sequence = 0;
+        if (hc_is_socket(con)) {
+            sequence = hc_hook_sequence(con);
+            unsigned long long missed = hc_hooks_missed(con);
+            if (missed > 0) {
+                fprintf(stderr, "Warning: missed %llu hooks\n", missed);
+            }
+        }
+        // on the socket, the server only sends the matching hooks
+        for (int i = 0; i < argc && i < hook_argc && !hc_is_socket(con); i++) {
             if (0 != regexec(g_hook_regex + i, hook_argv[i], 0, NULL, 0)) {
                 // found an regex that did not match
                 // so skip this
@@ -139,6 +188,9 @@ int main_hook(int argc, char* argv[]) {
             }
         }
         if (print_signal) {
+            if (g_print_sequence) {
+                printf("%llu\t", sequence);
+            }
             if (g_print_last_arg_only) {
                 // just drop hooks without content
                 if (hook_argc >= 1) {
@@ -168,11 +220,211 @@ int main_hook(int argc, char* argv[]) {
         }
     }
     hc_disconnect(con);
-    XCloseDisplay(display);
+    if (display) {
+        XCloseDisplay(display);
+    }
     destroy_hook_regex();
     return exit_code;
 }
 
+// the commands of a batch, with their location for error messages
+typedef struct {
+    const char* filename;
+    int         line;
+    int         argc;
+    char**      argv;
+} BatchCommand;
+
+// the number of requests of a batch that are sent before reading a reply
+#define BATCH_MAX_IN_FLIGHT 64
+
+// read an entire file into a null-terminated buffer
+static char* read_entire_file(FILE* file, size_t* ret_len) {
+    size_t len = 0;
+    size_t capacity = 4096;
+    char* buf = malloc(capacity);
+    while (buf) {
+        len += fread(buf + len, 1, capacity - len - 1, file);
+        if (len < capacity - 1) {
+            break;
+        }
+        capacity *= 2;
+        char* new_buf = realloc(buf, capacity);
+        if (!new_buf) {
+            free(buf);
+        }
+        buf = new_buf;
+    }
+    if (!buf) {
+        fprintf(stderr, "cannot malloc - there is no memory available\n");
+        exit(EXIT_FAILURE);
+    }
+    buf[len] = '\0';
+    *ret_len = len;
+    return buf;
+}
+
+// split the content of the given file into commands and append them
+static bool parse_batch_file(const char* filename,
+                             BatchCommand** commands, int* count) {
+    FILE* file = stdin;
+    if (strcmp(filename, "-") != 0) {
+        file = fopen(filename, "r");
+        if (!file) {
+            fprintf(stderr, "Error: Cannot open \"%s\": %s\n",
+                    filename, strerror(errno));
+            return false;
+        }
+    }
+    size_t len;
+    char* content = read_entire_file(file, &len);
+    if (file != stdin) {
+        fclose(file);
+    }
+    char delim = g_null_char_as_delim ? '\0' : '\n';
+    int line = 0;
+    for (char* record = content; record < content + len; ) {
+        char* end = memchr(record, delim, content + len - record);
+        if (!end) {
+            end = content + len;
+        }
+        *end = '\0';
+        line++;
+        BatchCommand cmd = { filename, line, 0, NULL };
+        if (!argv_split(record, &cmd.argc, &cmd.argv)) {
+            fprintf(stderr, "Error: %s:%d: %s\n", filename, line,
+                    errno == ENOMEM ? strerror(errno) : "unmatched quote");
+            free(content);
+            return false;
+        }
+        record = end + 1;
+        if (cmd.argc == 0) {
+            // an empty line or a comment
+            continue;
+        }
+        BatchCommand* new_commands = realloc(*commands, sizeof(BatchCommand) * (*count + 1));
+        if (!new_commands) {
+            fprintf(stderr, "cannot malloc - there is no memory available\n");
+            exit(EXIT_FAILURE);
+        }
+        *commands = new_commands;
+        (*commands)[(*count)++] = cmd;
+    }
+    free(content);
+    return true;
+}
+
+// send the commands in the given files (or stdin if there are none) and
+// print the replies in order. Returns the exit status of the first
+// failing command.
+int main_batch(int argc, char* argv[]) {
+    BatchCommand* commands = NULL;
+    int count = 0;
+    bool parsed = true;
+    if (argc == 0) {
+        parsed = parse_batch_file("-", &commands, &count);
+    }
+    for (int i = 0; i < argc && parsed; i++) {
+        parsed = parse_batch_file(argv[i], &commands, &count);
+    }
+    int exit_code = EXIT_FAILURE;
+    HCConnection* con = NULL;
+    if (!parsed) {
+        goto cleanup;
+    }
+    con = hc_connect_socket();
+    if (!con) {
+        con = hc_connect();
+    }
+    if (!con) {
+        if (!g_quiet) {
+            fprintf(stderr, "Error: Cannot open display.\n");
+        }
+        goto cleanup;
+    }
+    if (!hc_check_running(con)) {
+        if (!g_quiet) {
+            fprintf(stderr, "Error: herbstluftwm is not running.\n");
+        }
+        goto cleanup;
+    }
+    // on a socket, send further requests before waiting for the first
+    // reply. Only a limited number of them is in flight, such that the
+    // unread replies do not pile up in the server.
+    // Via X, every command has to wait for the reply of the previous one.
+    bool pipelined = hc_is_socket(con);
+    bool send_failed = false;
+    int sent = 0;
+    exit_code = 0;
+    for (int i = 0; i < count; i++) {
+        while (pipelined && !send_failed && sent < count
+               && sent < i + BATCH_MAX_IN_FLIGHT)
+        {
+            if (hc_send_request(con, commands[sent].argc, commands[sent].argv)) {
+                sent++;
+            } else {
+                send_failed = true;
+            }
+        }
+        char* output;
+        int command_status;
+        bool suc;
+        if (pipelined) {
+            suc = i < sent && hc_read_reply(con, &output, &command_status);
+        } else {
+            suc = hc_send_command(con, commands[i].argc, commands[i].argv,
+                                  &output, &command_status);
+        }
+        if (!suc) {
+            if (!g_quiet) {
+                fprintf(stderr, "Error: Could not send command.\n");
+            }
+            exit_code = EXIT_FAILURE;
+            break;
+        }
+        print_output(output, command_status);
+        if (command_status != 0) {
+            fprintf(stderr, "Error: %s:%d: %s returned %d\n",
+                    commands[i].filename, commands[i].line,
+                    commands[i].argv[0], command_status);
+            if (exit_code == 0) {
+                exit_code = command_status;
+            }
+        }
+        if (command_status == HERBST_NEED_MORE_ARGS) {
+            fprintf(stderr, "%s: not enough arguments\n", commands[i].argv[0]);
+        }
+        free(output);
+    }
+cleanup:
+    hc_disconnect(con);
+    for (int i = 0; i < count; i++) {
+        argv_free(commands[i].argc, commands[i].argv);
+    }
+    free(commands);
+    return exit_code;
+}
+
+// print the output of a command, to stderr if it failed
+void print_output(const char* output, int command_status) {
+    FILE* file = stdout; // on success, output to stdout
+    if (command_status != 0) { // any error, output to stderr
+        file = stderr;
+        // keep the order of the replies of a batch
+        fflush(stdout);
+    }
+    fputs(output, file);
+    if (g_batch && g_null_char_as_delim) {
+        // the replies of a batch are null-terminated
+        fputc('\0', file);
+    } else if (g_ensure_newline) {
+        size_t output_len = strlen(output);
+        if (output_len > 0 && output[output_len - 1] != '\n') {
+            fputs("\n", file);
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     static struct option long_options[] = {
         {"no-newline", 0, 0, 'n'},
@@ -180,6 +432,9 @@ int main(int argc, char* argv[]) {
         {"last-arg", 0, 0, 'l'},
         {"wait", 0, 0, 'w'},
         {"count", 1, 0, 'c'},
+        {"batch", 0, 0, 'b'},
+        {"sequence", 0, 0, 's'},
+        {"resume", 1, 0, 'r'},
         {"idle", 0, 0, 'i'},
         {"quiet", 0, 0, 'q'},
         {"version", 0, 0, 'v'},
@@ -189,7 +444,7 @@ int main(int argc, char* argv[]) {
     // parse options
     while (1) {
         int option_index = 0;
-        int c = getopt_long(argc, argv, "+n0lwc:iqhv", long_options, &option_index);
+        int c = getopt_long(argc, argv, "+n0lwc:bsr:iqhv", long_options, &option_index);
         if (c == -1) {
             break;
         }
@@ -204,6 +459,19 @@ int main(int argc, char* argv[]) {
             case 'w':
                 g_wait_for_hook = 1;
                 break;
+            case 'b':
+                g_batch = true;
+                break;
+            case 's':
+                g_print_sequence = true;
+                break;
+            case 'r':
+                if (optarg[0] < '0' || optarg[0] > '9') {
+                    fprintf(stderr, "Error: Invalid sequence number \"%s\"\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                g_resume_since = optarg;
+                break;
             case 'n':
                 g_ensure_newline = 0;
                 break;
@@ -227,8 +495,8 @@ int main(int argc, char* argv[]) {
         }
     }
     int arg_index = optind; // index of the first-non-option argument
-    if ((argc - arg_index == 0) && !g_wait_for_hook) {
-        // if there are no non-option arguments, and no --idle/--wait, display
+    if ((argc - arg_index == 0) && !g_wait_for_hook && !g_batch) {
+        // if there are no non-option arguments, and no --idle/--wait/--batch, display
         // the help and exit
         fprintf(stderr, "Error: COMMAND or --wait or --idle missing.\n");
         print_help(argv[0], stderr);
@@ -239,9 +507,15 @@ int main(int argc, char* argv[]) {
     if (g_wait_for_hook == 1) {
         // install signals
         command_status = main_hook(argc-arg_index, argv+arg_index);
+    } else if (g_batch) {
+        command_status = main_batch(argc-arg_index, argv+arg_index);
     } else {
         char* output;
-        HCConnection* con = hc_connect();
+        // prefer the unix socket and fall back to the X transport
+        HCConnection* con = hc_connect_socket();
+        if (!con) {
+            con = hc_connect();
+        }
         if (!con) {
             if (!g_quiet) {
                 fprintf(stderr, "Error: Cannot open display.\n");
@@ -264,17 +538,7 @@ int main(int argc, char* argv[]) {
             }
             return EXIT_FAILURE;
         }
-        FILE* file = stdout; // on success, output to stdout
-        if (command_status != 0) { // any error, output to stderr
-            file = stderr;
-        }
-        fputs(output, file);
-        if (g_ensure_newline) {
-            size_t output_len = strlen(output);
-            if (output_len > 0 && output[output_len - 1] != '\n') {
-                fputs("\n", file);
-            }
-        }
+        print_output(output, command_status);
         if (command_status == HERBST_NEED_MORE_ARGS) { // needs more arguments
             fprintf(stderr, "%s: not enough arguments\n", argv[arg_index]); // first argument == cmd
         }
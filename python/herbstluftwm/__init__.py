@@ -1,7 +1,10 @@
 #!/usr/bin/env python3
+import os
 import shlex
+import socket
+import struct
 import subprocess
-from typing import List
+from typing import List, Optional, Tuple
 """
 Python bindings for herbstluftwm. The central entity for communication
 with the herbstluftwm server is the Herbstluftwm class. See the example.py
@@ -14,6 +17,73 @@ for example usages of the classes provided here.
 """
 
 
+class SocketConnection:
+    """A long-lived connection to herbstluftwm via its unix socket. It
+    speaks the protocol described in src/ipc-protocol.h, so it does not
+    need to spawn herbstclient for every command.
+    """
+
+    # the exit status of a command that was given too few arguments
+    NEED_MORE_ARGS = 9
+
+    def __init__(self, path, timeout=None):
+        """Connect to the socket at the given path. Raises OSError
+        if herbstluftwm does not listen on it."""
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            self.sock.settimeout(timeout)
+            self.sock.connect(path)
+        except OSError:
+            self.sock.close()
+            raise
+        self.reader = self.sock.makefile('rb')
+
+    @staticmethod
+    def path(env=None) -> Optional[str]:
+        """the path of the socket for the display in the given
+        environment (by default the environment of this process), in the
+        same way as hc_socket_path() in the ipc-client."""
+        if env is None:
+            env = os.environ
+        runtime_dir = env.get('XDG_RUNTIME_DIR')
+        display = env.get('DISPLAY')
+        if not runtime_dir or display is None:
+            return None
+        # drop the screen number and replace every '/' by '_'
+        host, colon, number = display.rpartition(':')
+        if colon:
+            display = host + colon + number.split('.')[0]
+        display = display.replace('/', '_')
+        return os.path.join(runtime_dir, 'herbstluftwm', 'socket' + display)
+
+    def call_many(self, commands: List[List[str]]) -> List[Tuple[int, str]]:
+        """Send all commands before reading any reply and return the
+        pairs of exit status and output in the order of the commands.
+        Raises OSError or EOFError if the connection breaks."""
+        requests = []
+        for args in commands:
+            payload = b''.join(arg.encode() + b'\0' for arg in args)
+            requests.append(struct.pack('!I', len(payload)) + payload)
+        self.sock.sendall(b''.join(requests))
+        return [self._read_reply() for _ in commands]
+
+    def _read_exactly(self, size) -> bytes:
+        data = self.reader.read(size)
+        if len(data) < size:
+            raise EOFError('herbstluftwm closed the connection')
+        return data
+
+    def _read_reply(self) -> Tuple[int, str]:
+        length, = struct.unpack('!I', self._read_exactly(4))
+        status, = struct.unpack('!i', self._read_exactly(4))
+        output = self._read_exactly(length - 4)
+        return status, output.decode(errors='replace')
+
+    def close(self):
+        self.reader.close()
+        self.sock.close()
+
+
 class Herbstluftwm:
     """A herbstluftwm wrapper class that
     gives access to the remote interface of herbstluftwm.
@@ -24,13 +94,21 @@ class Herbstluftwm:
         print(Herbstluftwm().call(['add', 'new_tag']).stdout)
     """
 
-    def __init__(self, herbstclient='herbstclient'):
+    def __init__(self, herbstclient='herbstclient', persistent=False):
         """
         Create a wrapper object. The herbstclient parameter is
         the path or command to the 'herbstclient' executable.
+        If persistent is set, then the commands are sent over a single
+        connection to the unix socket of herbstluftwm instead of
+        running herbstclient for every command. If herbstluftwm does not
+        listen on a socket, herbstclient is used nevertheless.
         """
         self.herbstclient_path = herbstclient
         self.env = None
+        self.persistent = persistent
+        self.connection = None
+        # the timeout in seconds for a command
+        self.timeout = 2
 
     def _parse_command(self, cmd):
         """
@@ -44,19 +122,62 @@ class Herbstluftwm:
             args = shlex.split(cmd)
         return args
 
-    def unchecked_call(self, cmd):
-        """Call the command but do not check exit code or stderr"""
-        args = self._parse_command(cmd)
+    def _connect(self) -> Optional[SocketConnection]:
+        """return the persistent connection, if there is one"""
+        if self.persistent and self.connection is None:
+            path = SocketConnection.path(self.env)
+            if path is not None:
+                try:
+                    self.connection = SocketConnection(path, timeout=self.timeout)
+                except OSError:
+                    pass
+        return self.connection
+
+    def disconnect(self):
+        """close the persistent connection. It is reopened on the
+        next call."""
+        if self.connection is not None:
+            self.connection.close()
+            self.connection = None
+
+    @staticmethod
+    def _completed_process(args, status, output):
+        """return what herbstclient -n would return for this reply"""
+        stdout, stderr = (output, '') if status == 0 else ('', output)
+        if status == SocketConnection.NEED_MORE_ARGS:
+            stderr += f'{args[0]}: not enough arguments\n'
+        return subprocess.CompletedProcess(args, status, stdout, stderr)
+
+    def _call_on_connection(self, connection, commands):
+        try:
+            replies = connection.call_many(commands)
+        except socket.timeout:
+            self.disconnect()
+            raise subprocess.TimeoutExpired(commands, self.timeout)
+        except (OSError, EOFError):
+            # the same as herbstclient does if herbstluftwm quits
+            # before replying
+            self.disconnect()
+            replies = [(1, 'Error: Could not send command.\n')] * len(commands)
+        return [self._completed_process(args, status, output)
+                for args, (status, output) in zip(commands, replies)]
 
-        proc = subprocess.run([self.herbstclient_path, '-n'] + args,
+    def _run_herbstclient(self, args):
+        return subprocess.run([self.herbstclient_path, '-n'] + args,
                               stdout=subprocess.PIPE, stderr=subprocess.PIPE,
                               env=self.env,
                               universal_newlines=True,
                               # Kill hc when it hangs due to crashed server:
-                              timeout=2
+                              timeout=self.timeout
                               )
 
-        return proc
+    def unchecked_call(self, cmd):
+        """Call the command but do not check exit code or stderr"""
+        args = self._parse_command(cmd)
+        connection = self._connect()
+        if connection is not None:
+            return self._call_on_connection(connection, [args])[0]
+        return self._run_herbstclient(args)
 
     def call(self, cmd):
         """call the command and expect it to have exit code zero
@@ -66,6 +187,25 @@ class Herbstluftwm:
         assert not proc.stderr
         return proc
 
+    def unchecked_call_many(self, cmds) -> List[subprocess.CompletedProcess]:
+        """Call all the commands but do not check exit codes or stderr.
+        On a persistent connection, all commands are sent before waiting
+        for the first reply."""
+        commands = [self._parse_command(cmd) for cmd in cmds]
+        connection = self._connect()
+        if connection is not None:
+            return self._call_on_connection(connection, commands)
+        return [self._run_herbstclient(args) for args in commands]
+
+    def call_many(self, cmds) -> List[subprocess.CompletedProcess]:
+        """call all the commands and expect each of them to have exit
+        code zero and no output on stderr"""
+        procs = self.unchecked_call_many(cmds)
+        for proc in procs:
+            assert proc.returncode == 0
+            assert not proc.stderr
+        return procs
+
     @property
     def attr(self) -> 'AttributeProxy':
         """return an attribute proxy"""
@@ -10,9 +10,14 @@ hc() { "${herbstclient_command[@]:-herbstclient}" "$@" ;}
 # and sometime later:
 # loadstate.sh < mystate
 
-while read line ; do
+# quote an argument for herbstclient --batch, which only understands
+# plain posix quoting and not bash's $'...'
+quote() { printf "'%s'" "${1//\'/\'\\\'\'}" ;}
+
+# all commands are sent in one batch over a single connection
+while read -r line ; do
     tag="${line%%: *}"
     tree="${line#*: }"
-    hc add "$tag"
-    hc load "$tag" "$tree"
-done
+    printf 'add %s\n' "$(quote "$tag")"
+    printf 'load %s %s\n' "$(quote "$tag")" "$(quote "$tree")"
+done | hc --batch
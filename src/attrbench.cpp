@@ -0,0 +1,128 @@
+/** A micro-benchmark of the attribute lookup, on an object tree with
+ * the shape of herbstluftwm's tree and on the paths that scripts and
+ * panels typically read: static paths like 'tags.3.name' and paths
+ * through dynamic children like 'tags.focus.name'. It compares
+ * Object::deepAttribute(), which parses the path on every read, with
+ * the compiled AttributePath handles and with the path cache of the
+ * attribute commands.
+ *
+ * Build it with 'make attrbench' in the build directory.
+ */
+
+#include <X11/Xlib.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "attribute_.h"
+#include "attributepath.h"
+#include "child.h"
+#include "metacommands.h"
+#include "object.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+// these are defined in main.cpp, which is not linked into the benchmark
+int g_verbose = 0;
+Display* g_display = nullptr;
+Window g_root = 0;
+
+class Item : public Object {
+public:
+    Item(const string& name, int index)
+        : name_(this, "name", name)
+        , index_(this, "index", index)
+        , title_(this, "title", "item " + name)
+    { }
+    Attribute_<string> name_;
+    Attribute_<int> index_;
+    Attribute_<string> title_;
+};
+
+class Collection : public Object {
+public:
+    Collection(const string& prefix, int count)
+        : count_(this, "count", count)
+        , focus_(*this, "focus", &Collection::focus)
+    {
+        for (int i = 0; i < count; i++) {
+            string name = prefix + std::to_string(i);
+            items_.emplace_back(new Item(name, i));
+            addChild(items_.back().get(), name);
+        }
+    }
+    Item* focus() { return items_.empty() ? nullptr : items_[1].get(); }
+    Attribute_<int> count_;
+    DynChild_<Item> focus_;
+private:
+    vector<unique_ptr<Item>> items_;
+};
+
+class BenchRoot : public Object {
+public:
+    BenchRoot()
+        : tags(*this, "tags", "", 10)
+        , clients(*this, "clients", "0x140000", 50)
+        , settings(*this, "settings", "", 0)
+    {
+        for (int i = 0; i < 60; i++) {
+            settingsAttributes_.emplace_back(
+                new Attribute_<int>("setting_" + std::to_string(i), i));
+            settings.addAttribute(settingsAttributes_.back().get());
+        }
+    }
+    ChildMember_<Collection> tags;
+    ChildMember_<Collection> clients;
+    ChildMember_<Collection> settings;
+private:
+    vector<unique_ptr<Attribute>> settingsAttributes_;
+};
+
+static const vector<string> paths = {
+    "settings.setting_42",
+    "tags.count",
+    "tags.3.name",
+    "tags.focus.name",
+    "clients.0x14000017.title",
+    "clients.focus.title",
+};
+
+static double nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+template<typename Lookup>
+static void measure(const char* name, Lookup lookup) {
+    const int reads = 100000;
+    size_t length = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++) {
+        Attribute* a = lookup(i % paths.size());
+        length += a ? a->str().size() : 0;
+    }
+    double total = nanosecondsSince(start);
+    printf("%-16s %d reads: %7.2f ms   per read: %6.1f ns   (%zu bytes)\n",
+           name, reads, total / 1e6, total / reads, length);
+}
+
+int main(int argc, char** argv) {
+    BenchRoot root;
+    measure("deepAttribute", [&](size_t i) {
+        return root.deepAttribute(paths[i]);
+    });
+    MetaCommands metaCommands(root);
+    measure("path cache", [&](size_t i) {
+        return metaCommands.cachedAttribute(paths[i]);
+    });
+    vector<AttributePath> handles(paths.begin(), paths.end());
+    measure("AttributePath", [&](size_t i) {
+        return handles[i].resolve(root);
+    });
+    return 0;
+}
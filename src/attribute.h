@@ -49,6 +49,7 @@ public:
 
     // set the owner after object creation (when pointer is available)
     void setOwner(Object *owner) { owner_ = owner; }
+    Object* owner() const { return owner_; }
     // make this attribute writable (default is typically read-only)
     void setWritable(bool writable = true) { writable_ = writable; }
     // change if attribute can be expected to trigger hooks (rarely used)
@@ -5,6 +5,7 @@
 #include <stdexcept>
 
 #include "attribute.h"
+#include "hook.h"
 #include "object.h"
 #include "rectangle.h"
 #include "signal.h"
@@ -133,11 +134,20 @@ public:
         // decide whether the signals should be emitted based on
         // T's specific comparison operator.
         bool properChange = payload_ != payload;
+        Hook* recorder = (properChange && hookable_ && owner_)
+                         ? owner_->changeRecorder() : nullptr;
+        std::string oldValue;
+        if (recorder) {
+            oldValue = str();
+        }
         // The actual values are copied in any case:
         payload_ = payload;
         // But the signals are only emitted if the value really changed:
         if (properChange) {
             notifyHooks();
+            if (recorder && recorder == owner_->changeRecorder()) {
+                recorder->attributeValueChanged(this, oldValue);
+            }
             changed_.emit(payload);
         }
     }
@@ -0,0 +1,245 @@
+#include "attributejournal.h"
+
+#include <algorithm>
+
+#include "argparse.h"
+#include "completion.h"
+#include "ipc-protocol.h"
+#include "utils.h"
+
+using std::endl;
+using std::string;
+using std::vector;
+
+AttributeJournal::AttributeJournal()
+    : capacity_(this, "capacity", 1000)
+    , sequence_(this, "sequence", &AttributeJournal::sequence)
+{
+    setDoc("A record of the most recent attribute changes, "
+           "see the command 'attr_changes'.");
+    capacity_.setWritable();
+    capacity_.setDoc(
+        "the maximum number of changes that are kept. If this is 0, "
+        "then no changes are recorded.");
+    capacity_.changed().connect(this, &AttributeJournal::capacityChanged);
+    sequence_.setDoc(
+        "the number of recorded changes so far, which is also the "
+        "sequence number of the most recent change");
+}
+
+AttributeJournal::~AttributeJournal()
+{
+    for (const auto& it : paths_) {
+        it.first->removeHook(this);
+        it.first->setChangeRecorder(nullptr);
+    }
+}
+
+void AttributeJournal::injectDependencies(Object* root)
+{
+    root_ = root;
+    if (capacity_() > 0) {
+        track(root_, "");
+    }
+}
+
+int AttributeJournal::changesCommand(Input input, Output output)
+{
+    unsigned long since = 0;
+    ArgParse args = ArgParse().mandatory(since);
+    if (args.parsingAllFails(input, output)) {
+        return args.exitCode();
+    }
+    if (since > sequence()) {
+        output << input.command() << ": there are only "
+               << sequence() << " changes so far" << endl;
+        return HERBST_INVALID_ARGUMENT;
+    }
+    unsigned long oldest = changes_.empty() ? nextSequence_ : changes_.front().sequence;
+    if (since + 1 < oldest) {
+        output << input.command() << ": the changes after " << since
+               << " are not available anymore, the oldest change is "
+               << oldest << endl;
+        return HERBST_INVALID_ARGUMENT;
+    }
+    for (const auto& change : changes_) {
+        if (change.sequence <= since) {
+            continue;
+        }
+        output << change.sequence
+               << '\t' << change.path
+               << '\t' << tab_field_escape(change.oldValue)
+               << '\t' << tab_field_escape(change.newValue)
+               << '\n';
+    }
+    return 0;
+}
+
+void AttributeJournal::changesCompletion(Completion& complete)
+{
+    if (complete == 0) {
+        complete.full(std::to_string(sequence()));
+    } else {
+        complete.none();
+    }
+}
+
+void AttributeJournal::attributeValueChanged(Attribute* attribute, const string& oldValue)
+{
+    if (capacity_() == 0) {
+        // e.g. the capacity itself was just set to 0
+        return;
+    }
+    auto it = paths_.find(attribute->owner());
+    if (it == paths_.end()) {
+        // the object is not (yet) in the object tree
+        return;
+    }
+    // prefer 'tags.0' over 'tags.focus' and over 'tags.by-name.default'
+    auto shorter = [](const string& p1, const string& p2) {
+        auto depth1 = std::count(p1.begin(), p1.end(), OBJECT_PATH_SEPARATOR);
+        auto depth2 = std::count(p2.begin(), p2.end(), OBJECT_PATH_SEPARATOR);
+        return depth1 < depth2 || (depth1 == depth2 && p1 < p2);
+    };
+    const string& objectPath =
+        *std::min_element(it->second.begin(), it->second.end(), shorter);
+    changes_.push_back({
+        nextSequence_++,
+        childPath(objectPath, attribute->name()),
+        oldValue,
+        attribute->str(),
+    });
+    trim();
+}
+
+//! only hook the object tree while there is something to record
+void AttributeJournal::capacityChanged()
+{
+    trim();
+    bool tracking = !paths_.empty();
+    if (capacity_() > 0 && !tracking && root_) {
+        track(root_, "");
+    } else if (capacity_() == 0 && tracking) {
+        forget("", nullptr);
+    }
+}
+
+void AttributeJournal::trim()
+{
+    while (changes_.size() > capacity_()) {
+        changes_.pop_front();
+    }
+}
+
+void AttributeJournal::childAdded(Object* parent, string childName)
+{
+    auto it = paths_.find(parent);
+    if (it == paths_.end() || parent->hasDynamicChild(childName)) {
+        return;
+    }
+    Object* child = parent->child(childName);
+    for (const auto& parentPath : vector<string>(it->second)) {
+        string path = childPath(parentPath, childName);
+        // a link might have been replaced without removing it first
+        forget(path, nullptr);
+        if (child) {
+            track(child, path);
+        }
+    }
+}
+
+void AttributeJournal::childRemoved(Object* parent, string childName)
+{
+    auto it = paths_.find(parent);
+    if (it == paths_.end()) {
+        return;
+    }
+    for (const auto& parentPath : vector<string>(it->second)) {
+        forget(childPath(parentPath, childName), nullptr);
+    }
+}
+
+void AttributeJournal::objectDestroyed(Object* sender)
+{
+    auto it = paths_.find(sender);
+    if (it == paths_.end()) {
+        return;
+    }
+    for (const auto& path : vector<string>(it->second)) {
+        forget(path, sender);
+    }
+}
+
+//! track the object and all its static children under the given path
+void AttributeJournal::track(Object* object, const string& path)
+{
+    vector<string>& objectPaths = paths_[object];
+    for (const auto& existingPath : objectPaths) {
+        if (isBelow(path, existingPath)) {
+            // the object is its own descendant, so don't loop
+            return;
+        }
+    }
+    if (objectPaths.empty()) {
+        object->addHook(this);
+        object->setChangeRecorder(this);
+    }
+    objectPaths.push_back(path);
+    objects_[path] = object;
+    object->forEachChild([&](const string& name, Object* child) {
+        if (!object->hasDynamicChild(name)) {
+            track(child, childPath(path, name));
+        }
+    });
+}
+
+/** forget the path and all paths below it. The objects that are not
+ * reachable anymore are not hooked anymore, except for the object that
+ * is just being destroyed.
+ */
+void AttributeJournal::forget(const string& path, Object* destroyed)
+{
+    auto forgetEntry = [this,destroyed](std::map<string, Object*>::iterator entry) {
+        Object* object = entry->second;
+        vector<string>& objectPaths = paths_[object];
+        objectPaths.erase(std::remove(objectPaths.begin(), objectPaths.end(), entry->first),
+                          objectPaths.end());
+        if (objectPaths.empty()) {
+            paths_.erase(object);
+            if (object != destroyed) {
+                object->removeHook(this);
+                object->setChangeRecorder(nullptr);
+            }
+        }
+        return objects_.erase(entry);
+    };
+    auto it = objects_.find(path);
+    if (it != objects_.end()) {
+        forgetEntry(it);
+    }
+    // the paths below are all in one range
+    string prefix = path.empty() ? "" : path + OBJECT_PATH_SEPARATOR;
+    it = objects_.lower_bound(prefix);
+    while (it != objects_.end() && isBelow(it->first, path)) {
+        it = forgetEntry(it);
+    }
+}
+
+//! whether the path points to a descendant of the given ancestor
+bool AttributeJournal::isBelow(const string& path, const string& ancestor)
+{
+    if (ancestor.empty()) {
+        return !path.empty();
+    }
+    return path.size() > ancestor.size()
+        && path[ancestor.size()] == OBJECT_PATH_SEPARATOR
+        && path.compare(0, ancestor.size(), ancestor) == 0;
+}
+
+string AttributeJournal::childPath(const string& parentPath, const string& name)
+{
+    if (parentPath.empty()) {
+        return name;
+    }
+    return parentPath + OBJECT_PATH_SEPARATOR + name;
+}
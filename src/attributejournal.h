@@ -0,0 +1,66 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "attribute_.h"
+#include "commandio.h"
+#include "hook.h"
+#include "object.h"
+
+class Completion;
+
+/**
+ * A bounded record of the most recent changes of hookable attributes.
+ * Every change gets a sequence number, such that clients that missed
+ * some hooks or reconnect can catch up with 'attr_changes' instead of
+ * reading the entire object tree again.
+ *
+ * For knowing the path of a changed attribute, the journal hooks all
+ * objects that are reachable from the root via static children (links
+ * included) and keeps track of their paths. Dynamic children like
+ * 'clients.focus' do not announce when they change and so they are not
+ * followed. While the capacity is 0, no object is hooked at all.
+ */
+class AttributeJournal : public Object, public Hook {
+public:
+    AttributeJournal();
+    ~AttributeJournal() override;
+    void injectDependencies(Object* root);
+
+    Attribute_<unsigned long> capacity_;
+    DynAttribute_<unsigned long> sequence_;
+
+    int changesCommand(Input input, Output output);
+    void changesCompletion(Completion& complete);
+
+    void childAdded(Object* parent, std::string childName) override;
+    void childRemoved(Object* parent, std::string childName) override;
+    void objectDestroyed(Object* sender) override;
+    void attributeValueChanged(Attribute* attribute, const std::string& oldValue) override;
+private:
+    class Change {
+    public:
+        unsigned long sequence;
+        std::string path;
+        std::string oldValue;
+        std::string newValue;
+    };
+    void capacityChanged();
+    void trim();
+    unsigned long sequence() const { return nextSequence_ - 1; }
+    void track(Object* object, const std::string& path);
+    void forget(const std::string& path, Object* destroyed);
+    static std::string childPath(const std::string& parentPath, const std::string& name);
+    static bool isBelow(const std::string& path, const std::string& ancestor);
+
+    Object* root_ = nullptr;
+    unsigned long nextSequence_ = 1;
+    std::deque<Change> changes_;
+    //! the tracked objects by their path
+    std::map<std::string, Object*> objects_;
+    //! all paths of each tracked object. links make it more than one.
+    std::map<Object*, std::vector<std::string>> paths_;
+};
@@ -0,0 +1,55 @@
+#include "attributepath.h"
+
+#include "arglist.h"
+#include "object.h"
+
+using std::string;
+
+AttributePath::AttributePath(const string& path)
+    : path_(path)
+{
+    auto objectPathAndAttribute = Object::splitPath(path);
+    objectNames_ = objectPathAndAttribute.first.toVector();
+    attributeName_ = objectPathAndAttribute.second;
+}
+
+Attribute* AttributePath::resolve(Object& root)
+{
+    if (&root != root_ || generation_ != Object::structureGeneration()) {
+        resolveStaticPrefix(root);
+    }
+    if (!staticObject_) {
+        return nullptr;
+    }
+    if (staticLength_ == objectNames_.size()) {
+        return staticAttribute_;
+    }
+    Object* object = staticObject_;
+    for (size_t i = staticLength_; i < objectNames_.size(); i++) {
+        object = object->child(objectNames_[i]);
+        if (!object) {
+            return nullptr;
+        }
+    }
+    return object->attribute(attributeName_);
+}
+
+void AttributePath::resolveStaticPrefix(Object& root)
+{
+    root_ = &root;
+    generation_ = Object::structureGeneration();
+    Object* object = &root;
+    size_t i = 0;
+    for (; i < objectNames_.size() && object; i++) {
+        if (object->hasDynamicChild(objectNames_[i])) {
+            break;
+        }
+        object = object->child(objectNames_[i]);
+    }
+    staticLength_ = i;
+    staticObject_ = object;
+    staticAttribute_ = nullptr;
+    if (object && staticLength_ == objectNames_.size()) {
+        staticAttribute_ = object->attribute(attributeName_);
+    }
+}
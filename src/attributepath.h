@@ -0,0 +1,42 @@
+#ifndef __HLWM_ATTRIBUTEPATH_H_
+#define __HLWM_ATTRIBUTEPATH_H_
+
+#include <string>
+#include <vector>
+
+class Attribute;
+class Object;
+
+/** A path to an attribute in the object tree, e.g. 'tags.0.name', that is
+ * parsed only once. The objects on the path are only looked up again if
+ * the structure of the object tree has changed in the meantime, according
+ * to Object::structureGeneration(). Dynamic children (e.g. 'tags.focus')
+ * may point to another object at any time without such a change, so the
+ * part of the path starting at the first dynamic child is looked up on every
+ * resolve(), but still without parsing the path again.
+ */
+class AttributePath {
+public:
+    AttributePath(const std::string& path);
+    //! the attribute the path points to, or nullptr if it does not exist
+    Attribute* resolve(Object& root);
+    const std::string& path() const { return path_; }
+private:
+    void resolveStaticPrefix(Object& root);
+
+    std::string path_;
+    std::vector<std::string> objectNames_;
+    std::string attributeName_;
+
+    // the last resolution, valid as long as the generation is the same
+    Object* root_ = nullptr;
+    unsigned long generation_ = 0;
+    //! the number of names in objectNames_ before the first dynamic child
+    size_t staticLength_ = 0;
+    //! the object after the static names or nullptr if it does not exist
+    Object* staticObject_ = nullptr;
+    //! the attribute if all objects on the path are static children
+    Attribute* staticAttribute_ = nullptr;
+};
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <unistd.h>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
@@ -23,6 +24,7 @@
 #include "tag.h"
 #include "theme.h"
 #include "utils.h"
+#include "windowproperties.h"
 #include "xconnection.h"
 
 using std::string;
@@ -33,7 +35,8 @@ static int g_monitor_float_treshold = 24;
 static Client* lastfocus = nullptr;
 
 
-Client::Client(Window window, bool visible_already, ClientManager& cm)
+Client::Client(Window window, bool visible_already, ClientManager& cm,
+               const WindowProperties& properties)
     : window_(window)
     , dec(make_unique<Decoration>(this, *cm.settings))
     , float_size_(this, "floating_geometry",  {0, 0, 100, 100})
@@ -55,8 +58,10 @@ Client::Client(Window window, bool visible_already, ClientManager& cm)
     , ewmhnotify_(this, "ewmhnotify", true)
     , sizehints_floating_(this, "sizehints_floating", true)
     , sizehints_tiling_(this, "sizehints_tiling", false)
-    , window_class_(this, "class", &Client::getWindowClass)
-    , window_instance_(this, "instance", &Client::getWindowInstance)
+    , window_class_(this, "class", "")
+    , window_instance_(this, "instance", "")
+    , window_role_(this, "windowrole", "")
+    , window_type_(this, "windowtype", "")
     , content_geometry_(this, "content_geometry", {})
     , manager(cm)
     , theme(*cm.theme)
@@ -77,6 +82,13 @@ Client::Client(Window window, bool visible_already, ClientManager& cm)
     sizehints_floating_.setWritable();
     sizehints_tiling_.setWritable();
     minimized_.setWritable();
+    pseudotile_.changed().connect([this] {
+        // the max layout of the frame depends on it
+        auto frame = tag_ ? tag_->frame->findFrameWithClient(this) : nullptr;
+        if (frame) {
+            frame->invalidateLayout();
+        }
+    });
     for (auto i : {&fullscreen_, &pseudotile_, &sizehints_floating_, &sizehints_tiling_}) {
         i->changed().connect(this, &Client::requestRedraw);
     }
@@ -100,7 +112,7 @@ Client::Client(Window window, bool visible_already, ClientManager& cm)
     float_size_.setWritable();
     float_size_.changedByUser().connect(this, &Client::floatingGeometryChanged);
 
-    init_from_X();
+    init_from_X(properties);
     visible_.setDoc("whether this client is rendered currently");
     parent_frame_.setDoc("the frame contaning this client if the client is tiled");
     setDoc("a managed window");
@@ -123,6 +135,9 @@ Client::Client(Window window, bool visible_already, ClientManager& cm)
     pid_.setDoc("the process id of it (-1 if unset).");
     window_class_.setDoc("the class of it (second entry in WM_CLASS)");
     window_instance_.setDoc("the instance of it (first entry in WM_CLASS)");
+    window_role_.setDoc("the role of it (WM_WINDOW_ROLE)");
+    window_type_.setDoc("the first entry of its _NET_WM_WINDOW_TYPE "
+                        "if it is a known window type");
     fullscreen_.setDoc(
                 "whether this client covers all other "
                 "windows and panels on its monitor.");
@@ -152,19 +167,34 @@ Client::Client(Window window, bool visible_already, ClientManager& cm)
      );
 }
 
-void Client::init_from_X() {
+void Client::init_from_X(const WindowProperties& properties) {
     // treat wanted coordinates as floating coords
     auto root = Root::get();
-    auto globalGeometry = root->X.windowSize(window_);
-    float_size_ = root->monitors->interpretGlobalGeometry(globalGeometry);
+    float_size_ = root->monitors->interpretGlobalGeometry(properties.geometry);
     last_size_ = float_size_;
 
-    pid_ = Root::get()->X.windowPid(window_);
-    pgid_ = Root::get()->X.windowPgid(window_);
-
-    update_title();
-    update_wm_hints();
-    updatesizehints();
+    pid_ = properties.pid;
+    pgid_ = (properties.pid == -1) ? -1 : getpgid(properties.pid);
+
+    title_ = properties.title;
+    window_instance_ = properties.instance;
+    window_class_ = properties.windowClass;
+    has_window_role_ = properties.windowRole.has_value();
+    window_role_ = properties.windowRole.value_or("");
+    int windowType = ewmh.getWindowType(properties.windowType);
+    window_type_ = (windowType < 0) ? "" : ewmh.netatomName(windowType);
+    if (properties.wmHints.has_value()) {
+        XWMHints wmh = properties.wmHints.value();
+        update_wm_hints(wmh);
+    }
+    if (properties.sizeHints.has_value()) {
+        updatesizehints(properties.sizeHints.value());
+    } else {
+        XSizeHints size;
+        /* size is uninitialized, ensure that size.flags aren't used */
+        size.flags = PSize;
+        updatesizehints(size);
+    }
 }
 
 void Client::make_full_client() {
@@ -396,6 +426,10 @@ void Client::updatesizehints() {
         /* size is uninitialized, ensure that size.flags aren't used */
         size.flags = PSize;
     }
+    updatesizehints(size);
+}
+
+void Client::updatesizehints(const XSizeHints& size) {
     if(size.flags & PBaseSize) {
         this->basew_ = size.base_width;
         this->baseh_ = size.base_height;
@@ -581,15 +615,19 @@ void Client::update_wm_hints() {
     if (!wmh) {
         return;
     }
+    update_wm_hints(*wmh);
+    XFree(wmh);
+}
 
+void Client::update_wm_hints(XWMHints& wmh) {
     Client* focused_client = manager.focus();
     if ((focused_client == this)
-        && wmh->flags & XUrgencyHint) {
+        && wmh.flags & XUrgencyHint) {
         // remove urgency hint if window is focused
-        wmh->flags &= ~XUrgencyHint;
-        XSetWMHints(X_.display(), this->window_, wmh);
+        wmh.flags &= ~XUrgencyHint;
+        XSetWMHints(X_.display(), this->window_, &wmh);
     } else {
-        bool newval = (wmh->flags & XUrgencyHint) ? true : false;
+        bool newval = (wmh.flags & XUrgencyHint) ? true : false;
         if (newval != this->urgent_()) {
             this->urgent_ = newval;
             this->setup_border(focused_client == this);
@@ -597,12 +635,11 @@ void Client::update_wm_hints() {
             tag_set_flags_dirty();
         }
     }
-    if (wmh->flags & InputHint) {
-        this->neverfocus_ = !wmh->input;
+    if (wmh.flags & InputHint) {
+        this->neverfocus_ = !wmh.input;
     } else {
         this->neverfocus_ = false;
     }
-    XFree(wmh);
 }
 
 void Client::update_title() {
@@ -614,6 +651,23 @@ void Client::update_title() {
     }
 }
 
+void Client::update_class() {
+    auto hint = X_.getClassHint(window_);
+    window_instance_ = hint.first;
+    window_class_ = hint.second;
+}
+
+void Client::update_window_role() {
+    auto role = X_.getWindowProperty(window_, X_.atom("WM_WINDOW_ROLE"));
+    has_window_role_ = role.has_value();
+    window_role_ = role.value_or("");
+}
+
+void Client::update_window_type() {
+    int windowType = ewmh.getWindowType(window_);
+    window_type_ = (windowType < 0) ? "" : ewmh.netatomName(windowType);
+}
+
 Client* get_current_client() {
     return Root::get()->monitors->focus()->tag->focusedClient();
 }
@@ -637,16 +691,6 @@ void Client::floatingGeometryChanged()
     }
 }
 
-string Client::getWindowClass()
-{
-    return ewmh.X().getClass(window_);
-}
-
-string Client::getWindowInstance()
-{
-    return ewmh.X().getInstance(window_);
-}
-
 FrameLeaf* Client::parentFrame()
 {
     if (is_client_floated()) {
@@ -3,6 +3,7 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <X11/Xutil.h>
 
 #include "attribute_.h"
 #include "child.h"
@@ -23,11 +24,13 @@ class HSTag;
 class Monitor;
 class Settings;
 class ClientManager;
+class WindowProperties;
 class XConnection;
 
 class Client : public Object {
 public:
-    Client(Window w, bool visible_already, ClientManager& cm);
+    Client(Window w, bool visible_already, ClientManager& cm,
+           const WindowProperties& properties);
     ~Client() override;
 
     Window      window_;
@@ -38,6 +41,7 @@ public:
     Slice* slice = {};
     bool        ewmhfullscreen_ = false; // ewmh fullscreen state
     bool        neverfocus_ = false; // do not give the focus via XSetInputFocus
+    bool        has_window_role_ = false; // whether WM_WINDOW_ROLE is set (maybe to "")
     Attribute_<bool> visible_;
     bool        dragged_ = false;  // if this client is dragged currently
     int         ignore_unmaps_ = 0;  // Ignore one unmap for each reparenting
@@ -76,12 +80,14 @@ public:
     Attribute_<bool> ewmhnotify_; // send ewmh-notifications for this client
     Attribute_<bool> sizehints_floating_;  // respect size hints regarding this client in floating mode
     Attribute_<bool> sizehints_tiling_;  // respect size hints regarding this client in tiling mode
-    DynAttribute_<std::string> window_class_;
-    DynAttribute_<std::string> window_instance_;
+    Attribute_<std::string> window_class_;
+    Attribute_<std::string> window_instance_;
+    Attribute_<std::string> window_role_;
+    Attribute_<std::string> window_type_;
     Attribute_<Rectangle> content_geometry_;
 
 public:
-    void init_from_X();
+    void init_from_X(const WindowProperties& properties);
 
     void make_full_client();
     void listen_for_events();
@@ -111,13 +117,18 @@ public:
     bool is_client_floated();
     void set_urgent(bool state);
     void update_wm_hints();
+    void update_wm_hints(XWMHints& wmh);
     void update_title();
+    void update_class();
+    void update_window_role();
+    void update_window_type();
     void raise();
     void lower();
 
     void send_configure(bool force);
     bool applysizehints(int *w, int *h);
     void updatesizehints();
+    void updatesizehints(const XSizeHints& size);
 
     void set_visible(bool visible);
 
@@ -130,8 +141,6 @@ public:
     void updateEwmhState();
 private:
     void floatingGeometryChanged();
-    std::string getWindowClass();
-    std::string getWindowInstance();
     std::string triggerRelayoutMonitor();
     FrameLeaf* parentFrame();
     void requestRedraw();
@@ -21,6 +21,7 @@
 #include "tag.h"
 #include "tagmanager.h"
 #include "utils.h"
+#include "windowproperties.h"
 #include "xconnection.h"
 
 using std::endl;
@@ -95,6 +96,8 @@ Client* ClientManager::client(Window window)
 Client* ClientManager::parse(const string& identifier)
 {
     if (identifier.empty()) {
+        // the focus is only updated by the relayout
+        Root::get()->monitors->applyDirtyLayouts();
         Client* c = focus();
         if (c) {
             return c;
@@ -181,13 +184,17 @@ Client* ClientManager::manage_client(Window win, bool visible_already, bool forc
         return nullptr;
     }
 
+    // fetch all properties in a single round trip. The client caches
+    // them, so the rules do not need to query X again
+    WindowProperties properties = WindowProperties::fetch(*X_, win);
+
     // init client
-    auto client = new Client(win, visible_already, *this);
+    auto client = new Client(win, visible_already, *this, properties);
     client->listen_for_events();
     Monitor* m = get_current_monitor();
 
     // apply rules
-    ClientChanges changes = applyDefaultRules(client->window_);
+    ClientChanges changes = applyDefaultRules(properties);
     if (additionalRules) {
         additionalRules(changes);
     }
@@ -239,7 +246,7 @@ Client* ClientManager::manage_client(Window win, bool visible_already, bool forc
     if (changes.fullscreen.has_value()) {
         client->fullscreen_ = changes.fullscreen.value();
     } else {
-        client->fullscreen_ = ewmh->isFullscreenSet(client->window_);
+        client->fullscreen_ = ewmh->isFullscreenSet(properties.windowState);
     }
     ewmh->updateWindowState(client);
     // add client after setting the correct tag for the new client
@@ -282,10 +289,10 @@ Client* ClientManager::manage_client(Window win, bool visible_already, bool forc
 
 //! apply some built in rules that reflect the EWMH specification
 //! and regarding sensible single-window floating settings
-ClientChanges ClientManager::applyDefaultRules(Window win)
+ClientChanges ClientManager::applyDefaultRules(const WindowProperties& properties)
 {
     ClientChanges changes;
-    const int windowType = ewmh->getWindowType(win);
+    const int windowType = ewmh->getWindowType(properties.windowType);
     vector<int> unmanaged= {
         NetWmWindowTypeDesktop,
         NetWmWindowTypeDock,
@@ -312,7 +319,7 @@ ClientChanges ClientManager::applyDefaultRules(Window win)
     {
         changes.floating = True;
     }
-    if (X_->getTransientForHint(win).has_value()) {
+    if (properties.transientFor.has_value()) {
         changes.floating = true;
     }
     return changes;
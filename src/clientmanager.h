@@ -17,6 +17,7 @@ class Ewmh;
 class HSTag;
 class Settings;
 class Theme;
+class WindowProperties;
 class XConnection;
 
 template<>
@@ -62,7 +63,7 @@ public:
     // adds a new client to list of managed client windows
     Client* manage_client(Window win, bool visible_already, bool force_unmanage,
                           std::function<void(ClientChanges&)> additionalRules = {});
-    ClientChanges applyDefaultRules(Window win);
+    ClientChanges applyDefaultRules(const WindowProperties& properties);
 
     int applyRulesCmd(Input input, Output output);
     int applyRules(Client* client, Output output, bool changeFocus = true);
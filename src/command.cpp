@@ -90,7 +90,22 @@ int CommandTable::callCommand(Input args, Output out) const {
         return HERBST_COMMAND_NOT_FOUND;
     }
 
-    return cmd->second(args, out);
+    return callBinding(cmd->second, args, out);
+}
+
+/** call an already resolved command, e.g. the one of a key binding
+ */
+int CommandTable::callBinding(const CommandBinding& binding, Input args, Output out) {
+    if (binding.needsLayout()) {
+        // apply the relayouts scheduled by previous commands, e.g. by
+        // earlier commands in a 'chain', such that this command sees the
+        // current focus and the current window geometries.
+        auto root = Root::get();
+        if (root && root->monitors()) {
+            root->monitors->applyDirtyLayouts();
+        }
+    }
+    return binding(args, out);
 }
 
 namespace Commands {
@@ -119,6 +119,13 @@ public:
     bool hasCompletion() const { return (bool)completion_; }
     void complete(Completion& completion) const;
 
+    /** Mark the command as one that reads the window geometries or the
+     * focused client, such that the pending relayouts are applied before
+     * it is called.
+     */
+    CommandBinding& readsLayout() { readsLayout_ = true; return *this; }
+    bool needsLayout() const { return readsLayout_; }
+
     /** Call the stored command */
     int operator()(Input args, Output out) const { return command(args, out); }
 
@@ -130,6 +137,7 @@ private:
 
     std::function<int(Input, Output)> command;
     std::function<void(Completion&)>  completion_;
+    bool readsLayout_ = false;
 };
 
 class CommandTable {
@@ -140,6 +148,7 @@ public:
         : map(values) {}
 
     int callCommand(Input args, Output out) const;
+    static int callBinding(const CommandBinding& binding, Input args, Output out);
 
     Container::const_iterator begin() const { return map.cbegin(); }
     Container::const_iterator end() const { return map.cend(); }
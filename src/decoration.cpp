@@ -217,11 +217,6 @@ void Decoration::resize_outline(Rectangle outline, const DecorationScheme& schem
     inner.x = tile.x + ((dx < threshold) ? 0 : dx);
     inner.y = tile.y + ((dy < threshold) ? 0 : dy);
 
-    //if (RECTANGLE_EQUALS(client->last_size, rect)
-    //    && client->last_border_width == border_width) {
-    //    return;
-    //}
-
     if (scheme.tight_decoration()) {
         // updating the outline only has an affect for tiled clients
         // because for floating clients, this has been done already
@@ -251,40 +246,55 @@ void Decoration::resize_outline(Rectangle outline, const DecorationScheme& schem
     //}
     // send new size to client
     // update structs
-    bool size_changed = outline.width != last_outer_rect.width
-                     || outline.height != last_outer_rect.height;
+    bool size_changed = committed_outline_valid
+                     && (outline.width != committed_outline.width
+                         || outline.height != committed_outline.height);
     last_outer_rect = outline;
     last_rect_inner = false;
     client_->last_size_ = inner;
     last_scheme = &scheme;
+    bool updateClient = !client_->dragged_ || settings_.update_dragged_clients();
     // redraw
     // TODO: reduce flickering
-    if (!client_->dragged_ || settings_.update_dragged_clients()) {
+    if (updateClient) {
         last_actual_rect.x = changes.x;
         last_actual_rect.y = changes.y;
         last_actual_rect.width = changes.width;
         last_actual_rect.height = changes.height;
     }
-    redrawPixmap();
     XConnection& xcon = xconnection();
-    XSetWindowBackgroundPixmap(xcon.display(), decwin, pixmap);
-    if (!size_changed) {
-        // if size changes, then the window is cleared automatically
-        XClearWindow(xcon.display(), decwin);
+    if (redrawPixmap()) {
+        XSetWindowBackgroundPixmap(xcon.display(), decwin, pixmap);
+        if (!size_changed) {
+            // if size changes, then the window is cleared automatically
+            XClearWindow(xcon.display(), decwin);
+        }
     }
-    if (!client_->dragged_ || settings_.update_dragged_clients()) {
+    if (updateClient
+        && (!committed_inner_valid || committed_inner != last_actual_rect))
+    {
         XConfigureWindow(xcon.display(), win, mask, &changes);
         XMoveResizeWindow(xcon.display(), bgwin,
                           changes.x, changes.y,
                           changes.width, changes.height);
+        committed_inner_valid = true;
+        committed_inner = last_actual_rect;
+    }
+    if (!committed_outline_valid || committed_outline != outline) {
+        XMoveResizeWindow(xcon.display(), decwin,
+                          outline.x, outline.y, outline.width, outline.height);
+        committed_outline_valid = true;
+        committed_outline = outline;
     }
-    XMoveResizeWindow(xcon.display(), decwin,
-                      outline.x, outline.y, outline.width, outline.height);
     updateFrameExtends();
     if (!client_->dragged_ || settings_.update_dragged_clients()) {
+        // the synthetic ConfigureNotify is sent on the same connection as the
+        // above XConfigureWindow(), so the server processes it afterwards.
         client_->send_configure(false);
     }
-    XSync(xcon.display(), False);
+    // we do not XSync() here, because this would cause one round trip per
+    // client. Instead, the main loop flushes all requests of a relayout at
+    // once.
 }
 
 void Decoration::updateFrameExtends() {
@@ -292,7 +302,18 @@ void Decoration::updateFrameExtends() {
     int top  = last_inner_rect.y - last_outer_rect.y;
     int right = last_outer_rect.width - last_inner_rect.width - left;
     int bottom = last_outer_rect.height - last_inner_rect.height - top;
+    if (committed_extents_valid
+        && committed_extents[0] == left && committed_extents[1] == right
+        && committed_extents[2] == top && committed_extents[3] == bottom)
+    {
+        return;
+    }
     client_->ewmh.updateFrameExtents(client_->window_, left,right, top,bottom);
+    committed_extents_valid = true;
+    committed_extents[0] = left;
+    committed_extents[1] = right;
+    committed_extents[2] = top;
+    committed_extents[3] = bottom;
 }
 
 XConnection& Decoration::xconnection()
@@ -334,12 +355,38 @@ unsigned long Decoration::get_client_color(Color color) {
     }
 }
 
-// draw a decoration to the client->dec.pixmap
-void Decoration::redrawPixmap() {
+bool Decoration::PixmapInputs::operator==(const PixmapInputs& other) const {
+    return scheme == other.scheme
+        && schemeRevision == other.schemeRevision
+        && outer.width == other.outer.width
+        && outer.height == other.outer.height
+        && inner == other.inner
+        && actual == other.actual
+        && title == other.title;
+}
+
+/** draw a decoration to the client->dec.pixmap
+ * @return whether the pixmap was redrawn. If none of the inputs
+ * changed since the last call, then nothing is done.
+ */
+bool Decoration::redrawPixmap() {
     if (!last_scheme) {
         // do nothing if we don't have a scheme.
-        return;
+        return false;
+    }
+    PixmapInputs inputs;
+    inputs.scheme = last_scheme;
+    inputs.schemeRevision = last_scheme->revision();
+    inputs.outer = last_outer_rect;
+    inputs.inner = last_inner_rect;
+    inputs.inner.x -= last_outer_rect.x;
+    inputs.inner.y -= last_outer_rect.y;
+    inputs.actual = last_actual_rect;
+    inputs.title = client_->title_();
+    if (pixmap && inputs == committed_pixmap_) {
+        return false;
     }
+    committed_pixmap_ = inputs;
     XConnection& xcon = xconnection();
     Display* display = xcon.display();
     const DecorationScheme& s = *last_scheme;
@@ -411,7 +458,7 @@ void Decoration::redrawPixmap() {
     }
     if (s.title_height() > 0) {
         FontData& fontData = s.title_font->data();
-        string title = client_->title_();
+        const string& title = inputs.title;
         Point2D titlepos = {
             static_cast<int>(s.padding_left() + s.border_width()),
             static_cast<int>(s.title_height())
@@ -448,5 +495,6 @@ void Decoration::redrawPixmap() {
     }
     // clean up
     XFreeGC(display, gc);
+    return true;
 }
 
@@ -3,6 +3,7 @@
 
 #include <X11/X.h>
 #include <map>
+#include <string>
 
 #include "rectangle.h"
 #include "x11-types.h"
@@ -37,7 +38,7 @@ public:
 private:
     static Visual* check_32bit_client(Client* c);
     static XConnection& xconnection();
-    void redrawPixmap();
+    bool redrawPixmap();
     void updateFrameExtends();
     unsigned long get_client_color(Color color);
 
@@ -47,6 +48,25 @@ private:
     Rectangle   last_inner_rect = {0, 0, 0, 0}; // only valid if width >= 0
     Rectangle   last_outer_rect = {0, 0, 0, 0}; // only valid if width >= 0
     Rectangle   last_actual_rect = {0, 0, 0, 0}; // last actual client rect, relative to decoration
+    /* the state that was last sent to the X server. If the requested state
+     * equals the committed state, no X requests are sent at all. */
+    //! everything the pixmap content depends on
+    struct PixmapInputs {
+        const DecorationScheme* scheme = nullptr;
+        unsigned long schemeRevision = 0;
+        Rectangle outer = {0, 0, 0, 0};
+        Rectangle inner = {0, 0, 0, 0}; // relative to the decoration window
+        Rectangle actual = {0, 0, 0, 0};
+        std::string title;
+        bool operator==(const PixmapInputs& other) const;
+    };
+    PixmapInputs committed_pixmap_;
+    bool        committed_outline_valid = false;
+    Rectangle   committed_outline = {0, 0, 0, 0};
+    bool        committed_inner_valid = false;
+    Rectangle   committed_inner = {0, 0, 0, 0}; // relative to decoration
+    bool        committed_extents_valid = false;
+    int         committed_extents[4] = {0, 0, 0, 0}; // left, right, top, bottom
     /* X specific things */
     Visual*                 visual = nullptr;
     Colormap                colormap = 0;
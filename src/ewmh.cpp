@@ -70,16 +70,6 @@ const std::array<const char*,NetCOUNT> Ewmh::netatomNames_ =
 Ewmh::Ewmh(XConnection& xconnection)
     : X_(xconnection)
 {
-    /* init ewmh net atoms */
-    for (int i = 0; i < NetCOUNT; i++) {
-        if (!netatomNames_[i]) {
-            HSWarning("no name specified in g_netatom_names "
-                      "for atom number %d\n", i);
-            continue;
-        }
-        netatom_[i] = XInternAtom(X_.display(), netatomNames_[i], False);
-    }
-
     vector<pair<WM,const char*>> wm2name = {
         { WM::Name,         "WM_NAME" },
         { WM::Protocols,    "WM_PROTOCOLS" },
@@ -88,9 +78,29 @@ Ewmh::Ewmh(XConnection& xconnection)
         { WM::ChangeState,  "WM_CHANGE_STATE" },
         { WM::TakeFocus,    "WM_TAKE_FOCUS" },
     };
+    // intern all atoms in a single round trip
+    vector<string> allAtomNames = { windowManagerSelectionName() };
+    for (int i = 0; i < NetCOUNT; i++) {
+        if (netatomNames_[i]) {
+            allAtomNames.push_back(netatomNames_[i]);
+        }
+    }
+    for (const auto& init : wm2name) {
+        allAtomNames.push_back(init.second);
+    }
+    X_.internAtoms(allAtomNames);
+
+    /* init ewmh net atoms */
+    for (int i = 0; i < NetCOUNT; i++) {
+        if (!netatomNames_[i]) {
+            HSWarning("no name specified in g_netatom_names "
+                      "for atom number %d\n", i);
+            continue;
+        }
+        netatom_[i] = X_.atom(netatomNames_[i]);
+    }
     for (const auto& init : wm2name) {
-        auto atom = XInternAtom(X_.display(), init.second, False);
-        wmatom_[static_cast<size_t>(init.first)] = atom;
+        wmatom_[static_cast<size_t>(init.first)] = X_.atom(init.second);
     }
 
     readInitialEwmhState();
@@ -202,10 +212,14 @@ bool Ewmh::acquireScreenSelection(bool replaceExistingWm)
     return true;
 }
 
+string Ewmh::windowManagerSelectionName()
+{
+    return "WM_S" + to_string(X_.screen());
+}
+
 Atom Ewmh::windowManagerSelection()
 {
-    string atomName = "WM_S" + to_string(X_.screen());
-    return XInternAtom(X_.display(), atomName.c_str(), False);
+    return X_.atom(windowManagerSelectionName().c_str());
 }
 
 void Ewmh::InitialState::print(FILE *file)
@@ -540,6 +554,13 @@ bool Ewmh::isFullscreenSet(Window win) {
     return isWindowStateSet(win, netatom_[NetWmStateFullscreen]);
 }
 
+//! whether the given value of _NET_WM_STATE contains the fullscreen state
+bool Ewmh::isFullscreenSet(const vector<Atom>& windowState) {
+    Atom fullscreen = netatom_[NetWmStateFullscreen];
+    return std::find(windowState.begin(), windowState.end(), fullscreen)
+            != windowState.end();
+}
+
 void Ewmh::setWindowOpacity(Window win, double opacity) {
     /* Based on the EWMH proposal
      * https://mail.gnome.org/archives/wm-spec-list/2003-December/msg00035.html
@@ -648,10 +669,18 @@ string Ewmh::getWindowTitle(Window win) {
  */
 int Ewmh::getWindowType(Window win) {
     auto atoms = X_.getWindowPropertyAtom(win, netatom_[NetWmWindowType]);
-    if (!atoms.has_value() || atoms.value().empty()) {
+    if (!atoms.has_value()) {
+        return -1;
+    }
+    return getWindowType(atoms.value());
+}
+
+//! the window type for the given value of _NET_WM_WINDOW_TYPE
+int Ewmh::getWindowType(const vector<Atom>& windowTypes) {
+    if (windowTypes.empty()) {
         return -1;
     }
-    Atom windowtype = atoms.value()[0];
+    Atom windowtype = windowTypes[0];
     for (int i = NetWmWindowTypeFIRST; i <= NetWmWindowTypeLAST; i++) {
         // try to find the window type
         if (windowtype == netatom_[i]) {
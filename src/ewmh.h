@@ -151,10 +151,12 @@ public:
     void updateFrameExtents(Window win, int left, int right, int top, int bottom);
     bool isWindowStateSet(Window win, Atom hint);
     bool isFullscreenSet(Window win);
+    bool isFullscreenSet(const std::vector<Atom>& windowState);
     void clearClientProperties(Window win);
     std::string getWindowTitle(Window win);
 
     int getWindowType(Window win);
+    int getWindowType(const std::vector<Atom>& windowTypes);
 
     bool isOwnWindow(Window win);
     void clearInputFocus();
@@ -184,6 +186,7 @@ private:
     XConnection& X_;
     InitialState initialState_;
     void readInitialEwmhState();
+    std::string windowManagerSelectionName();
     Atom wmatom(WM proto);
     Atom wmatom_[(int)WM::Last] = {};
 
@@ -9,6 +9,7 @@
 #include "decoration.h"
 #include "layout.h"
 #include "monitor.h"
+#include "monitormanager.h"
 #include "settings.h"
 #include "tag.h"
 #include "utils.h"
@@ -215,6 +216,8 @@ int Floating::find_edge_right_of(RectangleIdxVec rects, int idx) {
 
 bool Floating::focusDirection(Direction dir) {
     if (g_settings->monitors_locked()) { return false; }
+    // the geometries of the clients are only updated by the relayout
+    g_monitors->applyDirtyLayouts();
     HSTag* tag = get_current_monitor()->tag;
     vector<Client*> clients;
     RectangleIdxVec rects;
@@ -316,6 +319,7 @@ Point2D Floating::find_rectangle_collision_on_tag(HSTag* tag, Client* curfocus,
 
 bool Floating::shiftDirection(Direction dir) {
     if (g_settings->monitors_locked()) { return false; }
+    g_monitors->applyDirtyLayouts();
     HSTag* tag = get_current_monitor()->tag;
     Client* curfocus = tag->focusedClient();
     if (!curfocus || !curfocus->is_client_floated()) {
@@ -425,6 +429,7 @@ bool Floating::resizeDirection(HSTag* tag, Client* client, Direction dir)
     if (!client || !client->is_client_floated()) {
         return false;
     }
+    g_monitors->applyDirtyLayouts();
     // 1. Try to grow into a specific direction
     if (grow_into_direction(tag, client, dir)) {
         return true;
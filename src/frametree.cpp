@@ -206,6 +206,7 @@ int FrameTree::rotateCommand() {
                     s->fraction_ = FixPrecDec::fromInteger(1) - s->fraction_;
                     break;
             }
+            s->invalidateLayout();
         };
     void (*onLeaf)(FrameLeaf*) =
         [] (FrameLeaf*) {
@@ -240,6 +241,7 @@ int FrameTree::mirrorCommand(Input input, Output output)
                 s->selection_ = s->selection_ ? 0 : 1;
                 s->swapChildren();
                 s->fraction_ = FixPrecDec::fromInteger(1) - s->fraction_;
+                s->invalidateLayout();
             }
         };
     root_->fmap(onSplit, [] (FrameLeaf*) { }, -1);
@@ -453,6 +455,7 @@ bool FrameTree::focusClient(Client* client) {
     auto& cs = frameLeaf->clients;
     int index = std::find(cs.begin(), cs.end(), client) - cs.begin();
     frameLeaf->selection = index;
+    frameLeaf->invalidateLayout();
     // 2. make the frame focused
     focusFrame(frameLeaf);
     return true;
@@ -469,6 +472,7 @@ void FrameTree::focusFrame(shared_ptr<Frame> frame) {
         } else {
             parent->selection_ = 1;
         }
+        parent->invalidateLayout();
         frame = parent;
     }
 }
@@ -771,6 +775,7 @@ void FrameTree::applyFrameTree(shared_ptr<Frame> target,
         targetLeaf->clients = clients;
         targetLeaf->setSelection(sourceLeaf->selection);
         targetLeaf->layout = sourceLeaf->layout;
+        targetLeaf->invalidateLayout();
     } else {
         // assert that target is a FrameSplit
         if (targetLeaf) {
@@ -783,6 +788,7 @@ void FrameTree::applyFrameTree(shared_ptr<Frame> target,
         targetSplit->align_ = sourceSplit->align_;
         targetSplit->fraction_ = sourceSplit->fraction_;
         targetSplit->selection_ = sourceSplit->selection_;
+        targetSplit->invalidateLayout();
         applyFrameTree(targetSplit->a_, sourceSplit->a_);
         applyFrameTree(targetSplit->b_, sourceSplit->b_);
     }
@@ -797,6 +803,7 @@ void FrameTree::replaceNode(shared_ptr<Frame> old,
         rootLink_ = root_.get();
         // root frame should never have a parent:
         root_->parent_ = {};
+        root_->invalidateLayout();
     } else {
         parent->replaceChild(old, replacement);
     }
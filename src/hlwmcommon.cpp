@@ -4,6 +4,7 @@
 
 #include "clientmanager.h"
 #include "command.h"
+#include "monitormanager.h"
 #include "root.h"
 
 using std::make_pair;
@@ -33,6 +34,9 @@ pair<int,string> HlwmCommon::callCommand(const vector<string>& call) {
         ? Input("", call)
         : Input(call[0], vector<string>(call.begin() + 1, call.end()));
     int status = Commands::call(input, output);
+    // apply the scheduled relayouts before the reply is sent, such that
+    // the caller already sees the updated window geometries.
+    Root::get()->monitors->applyDirtyLayouts();
     return make_pair(status, output.str());
 }
 
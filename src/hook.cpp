@@ -4,7 +4,7 @@
 #include <cstdio>
 
 #include "globals.h"
-#include "ipc-server.h"
+#include "hookcoalescer.h"
 #include "root.h"
 #include "tag.h"
 
@@ -12,7 +12,7 @@ using std::string;
 using std::vector;
 
 void hook_emit(vector<string> args) {
-    Root::get()->ipcServer_.emitHook(args);
+    Root::get()->hookCoalescer->emit(args);
 }
 
 void emit_tag_changed(HSTag* tag, int monitor) {
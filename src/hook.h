@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+class Attribute;
 class HSTag;
 class Object;
 
@@ -17,8 +18,14 @@ public:
     virtual void childAdded(Object* parent, std::string child_name) {}
     // this is called immediately before a child is removed
     virtual void childRemoved(Object* parent, std::string child_name) {}
-    // this is called after an attribute value has changed
+    // this is called after an attribute value has changed and
+    // after an attribute has been added or removed
     virtual void attributeChanged(Object* sender, std::string attribute_name) {}
+    // this is called when the object is destroyed
+    virtual void objectDestroyed(Object* sender) {}
+    // this is called after the value of a hookable attribute has changed,
+    // if the hook is the change recorder of the attribute's owner
+    virtual void attributeValueChanged(Attribute* attribute, const std::string& oldValue) {}
 };
 
 void hook_emit(std::vector<std::string> args);
@@ -0,0 +1,69 @@
+#include "hookcoalescer.h"
+
+#include <chrono>
+
+#include "ipc-server.h"
+#include "settings.h"
+#include "timerqueue.h"
+
+using std::string;
+using std::vector;
+
+HookCoalescer::HookCoalescer(IpcServer& ipcServer, TimerQueue& timers)
+    : ipcServer_(ipcServer)
+    , timers_(timers)
+{
+}
+
+void HookCoalescer::injectDependencies(Settings* settings)
+{
+    settings_ = settings;
+}
+
+void HookCoalescer::emit(const vector<string>& args)
+{
+    if (args.empty() || !settings_ || settings_->hook_coalesce_ms() == 0
+        || !settings_->hook_coalesce_hooks().matches(args[0]))
+    {
+        ipcServer_.emitHook(args);
+        return;
+    }
+    Key key = { args[0], args.size() > 1 ? args[1] : "" };
+    auto it = groups_.find(key);
+    if (it != groups_.end()) {
+        // the window is open, so only remember the most recent hook
+        if (it->second.pending.has_value()) {
+            suppressed_++;
+        }
+        it->second.pending = args;
+        return;
+    }
+    ipcServer_.emitHook(args);
+    groups_[key] = {};
+    timers_.schedule(std::chrono::milliseconds(settings_->hook_coalesce_ms()),
+                     [this, key]() { endWindow(key); });
+}
+
+void HookCoalescer::endWindow(const Key& key)
+{
+    auto it = groups_.find(key);
+    if (it == groups_.end()) {
+        return;
+    }
+    unsigned long milliseconds = settings_ ? settings_->hook_coalesce_ms() : 0;
+    if (!it->second.pending.has_value()) {
+        groups_.erase(it);
+        return;
+    }
+    ipcServer_.emitHook(it->second.pending.value());
+    if (milliseconds == 0) {
+        // coalescing was disabled in the meantime
+        groups_.erase(it);
+        return;
+    }
+    // open a new window, such that a continuous flood is emitted once
+    // per window
+    it->second.pending = {};
+    timers_.schedule(std::chrono::milliseconds(milliseconds),
+                     [this, key]() { endWindow(key); });
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "optional.h"
+
+class IpcServer;
+class Settings;
+class TimerQueue;
+
+/**
+ * Throttles hooks that are emitted at a high frequency, e.g. the
+ * window_title_changed hooks of a terminal running 'watch'. The hooks
+ * whose name matches the setting hook_coalesce_hooks are grouped by their
+ * name and first argument. The first hook of a group is emitted
+ * immediately. Afterwards, the group is emitted at most once per
+ * hook_coalesce_ms milliseconds, and only with its most recent arguments.
+ */
+class HookCoalescer {
+public:
+    HookCoalescer(IpcServer& ipcServer, TimerQueue& timers);
+    void injectDependencies(Settings* settings);
+    void emit(const std::vector<std::string>& args);
+    //! the number of hooks that were replaced by a more recent one
+    unsigned long suppressed() const { return suppressed_; }
+private:
+    using Key = std::pair<std::string, std::string>;
+    class Group {
+    public:
+        //! the hook that is emitted when the coalescing window ends
+        std::experimental::optional<std::vector<std::string>> pending;
+    };
+    void endWindow(const Key& key);
+
+    IpcServer& ipcServer_;
+    TimerQueue& timers_;
+    Settings* settings_ = nullptr;
+    //! the groups whose coalescing window is currently open
+    std::map<Key, Group> groups_;
+    unsigned long suppressed_ = 0;
+};
@@ -14,19 +14,43 @@
 // maximum number of hooks to buffer
 #define HERBST_HOOK_PROPERTY_COUNT 10
 
+// The unix socket transport listens on
+//   $XDG_RUNTIME_DIR/HERBST_IPC_SOCKET_DIR/HERBST_IPC_SOCKET_PREFIX<display>
+// where <display> is the display name without the screen number and with
+// every '/' replaced by '_'.
+//
+// Every message on the socket is framed by its length (4 bytes, unsigned,
+// network byte order), followed by that many bytes:
+//   - a request consists of the command and its arguments, each of them
+//     terminated by a null byte.
+//   - a reply consists of the exit status (4 bytes, signed, network byte
+//     order), followed by the output of the command.
+// A connection can carry arbitrarily many requests. The replies are sent in
+// the order of the requests.
+//
+// A request whose first argument is empty is a control request of the
+// connection. The request ("", HERBST_IPC_SOCKET_SUBSCRIBE, SEQ, FILTER...)
+// turns the connection into a hook stream: its reply contains the sequence
+// number of the next hook, and afterwards every message is a hook, consisting
+// of its sequence number (8 bytes, unsigned, network byte order), followed by
+// the null-terminated arguments of the hook. The sequence numbers increase by
+// one per hook. If SEQ is not empty, the stream starts with the hooks since
+// SEQ that are still in the backlog of the server. The n'th FILTER is a
+// regular expression that must match somewhere in the n'th argument of a
+// hook (i.e. the first FILTER applies to the hook name), otherwise the hook
+// is not sent to the subscriber. The hook stream ends when the client closes
+// the connection or shuts down its writing direction.
+// If hooks are lost, e.g. because the client did not read them fast enough,
+// then a message without any arguments is sent whose sequence number field
+// holds the number of lost hooks.
+#define HERBST_IPC_SOCKET_DIR "herbstluftwm"
+#define HERBST_IPC_SOCKET_PREFIX "socket"
+// maximum length of a message on the socket
+#define HERBST_IPC_SOCKET_MAX_MESSAGE (16 * 1024 * 1024)
+#define HERBST_IPC_SOCKET_SUBSCRIBE "subscribe"
+
 // function exit codes
-enum {
-    HERBST_EXIT_SUCCESS = 0,
-    HERBST_UNKNOWN_ERROR,
-    HERBST_COMMAND_NOT_FOUND,
-    HERBST_INVALID_ARGUMENT,
-    HERBST_SETTING_NOT_FOUND,
-    HERBST_TAG_IN_USE,
-    HERBST_FORBIDDEN,
-    HERBST_NO_PARAMETER_EXPECTED,
-    HERBST_ENV_UNSET,
-    HERBST_NEED_MORE_ARGS,
-};
+#include "../ipc-client/ipc-exit-status.h"
 
 #endif
 
@@ -15,6 +15,25 @@ IpcServer::IpcServer(XConnection& xconnection)
     : X(xconnection)
     , nextHookNumber_(0)
 {
+    // intern all atoms needed for ipc and hooks at once
+    vector<string> hookPropertyNames;
+    char atom_name[1000];
+    for (int i = 0; i < HERBST_HOOK_PROPERTY_COUNT; i++) {
+        snprintf(atom_name, 1000, HERBST_HOOK_PROPERTY_FORMAT, i);
+        hookPropertyNames.push_back(atom_name);
+    }
+    vector<string> atomNames = {
+        HERBST_HOOK_WIN_ID_ATOM,
+        HERBST_IPC_ARGS_ATOM,
+        HERBST_IPC_OUTPUT_ATOM,
+        HERBST_IPC_STATUS_ATOM,
+    };
+    atomNames.insert(atomNames.end(),
+                     hookPropertyNames.begin(), hookPropertyNames.end());
+    X.internAtoms(atomNames);
+    for (const auto& name : hookPropertyNames) {
+        hookPropertyAtoms_.push_back(X.atom(name.c_str()));
+    }
     // main task of the construtor is to setup the hook window
     hookEventWindow_ = XCreateSimpleWindow(X.display(), X.root(),
                                              42, 42, 42, 42, 0, 0, 0);
@@ -29,9 +48,21 @@ IpcServer::IpcServer(XConnection& xconnection)
     // set its window id in root window
     XChangeProperty(X.display(), X.root(), X.atom(HERBST_HOOK_WIN_ID_ATOM),
         XA_ATOM, 32, PropModeReplace, (unsigned char*)&hookEventWindow_, 1);
+    // in addition, listen on the unix socket, if there is a runtime dir
+    string socketPath = IpcSocketServer::socketPath(DisplayString(X.display()));
+    if (!socketPath.empty()) {
+        // in contrast to the replies via X, a reply on the socket is not
+        // ordered after the requests to the X server. So wait until the X
+        // server has processed them, before the client can query it.
+        socketServer_.setSyncHandler([this]() {
+            XSync(X.display(), False);
+        });
+        socketServer_.listen(socketPath);
+    }
 }
 
 IpcServer::~IpcServer() {
+    socketServer_.close();
     // remove property from root window
     XDeleteProperty(X.display(), X.root(), X.atom(HERBST_HOOK_WIN_ID_ATOM));
     XDestroyWindow(X.display(), hookEventWindow_);
@@ -86,10 +117,21 @@ void IpcServer::emitHook(vector<string> args) {
         // nothing to do
         return;
     }
-    static char atom_name[1000];
-    snprintf(atom_name, 1000, HERBST_HOOK_PROPERTY_FORMAT, nextHookNumber_);
-    X.setPropertyString(hookEventWindow_, X.atom(atom_name), args);
+    X.setPropertyString(hookEventWindow_, hookPropertyAtoms_[nextHookNumber_], args);
     // set counter for next property
     nextHookNumber_ += 1;
     nextHookNumber_ %= HERBST_HOOK_PROPERTY_COUNT;
+    // the hook stream on the socket does not lose hooks like the
+    // property ring does
+    socketServer_.emitHook(args);
+}
+
+int IpcServer::fillFdSets(fd_set* readFds, fd_set* writeFds) const {
+    return socketServer_.fillFdSets(readFds, writeFds);
+}
+
+void IpcServer::handleFdSets(const fd_set* readFds, const fd_set* writeFds,
+                             CallHandler callback) {
+    socketServer_.handleFdSets(readFds, writeFds, callback);
+    socketServer_.flush();
 }
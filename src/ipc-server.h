@@ -2,11 +2,14 @@
 #define __HERBSTLUFT_IPC_SERVER_H_
 
 #include <X11/X.h>
+#include <sys/select.h>
 #include <functional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ipc-socket-server.h"
+
 class XConnection;
 
 class IpcServer {
@@ -29,11 +32,22 @@ public:
     //! send a hook to all listening clients
     void emitHook(std::vector<std::string> args);
 
+    //! add the sockets of the unix socket transport to the given fd sets
+    //and return the highest fd, or -1 if there is none
+    int fillFdSets(fd_set* readFds, fd_set* writeFds) const;
+    //! run the requests on the unix socket transport that are ready
+    //according to the given fd sets and send the replies
+    void handleFdSets(const fd_set* readFds, const fd_set* writeFds,
+                      CallHandler callback);
+    const IpcSocketServer& socketServer() const { return socketServer_; }
+
 private:
     XConnection& X;
 
     Window hookEventWindow_; //! window on which the hooks are announced
     int nextHookNumber_; //! index for the next hook
+    std::vector<Atom> hookPropertyAtoms_; //! the atoms of the hook properties
+    IpcSocketServer socketServer_; //! the transport via the unix socket
 };
 
 #endif
@@ -0,0 +1,470 @@
+#include "ipc-socket-server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "globals.h"
+#include "ipc-protocol.h"
+#include "regexengine.h"
+#include "utils.h"
+
+using std::string;
+using std::vector;
+
+//! whether the error only says that the operation would block
+static bool wouldBlock(int error)
+{
+    // on most systems, EWOULDBLOCK is just another name for EAGAIN
+#if EAGAIN == EWOULDBLOCK
+    return error == EAGAIN;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+}
+
+IpcSocketServer::~IpcSocketServer()
+{
+    close();
+}
+
+/*!
+ * The path of the socket for the given X display, or the empty string if
+ * XDG_RUNTIME_DIR is not set. The same path is computed by
+ * hc_socket_path() in herbstclient.
+ */
+string IpcSocketServer::socketPath(const string& displayName)
+{
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (!runtimeDir || !runtimeDir[0]) {
+        return "";
+    }
+    // the screen number does not matter, so drop it
+    string display = displayName;
+    size_t colon = display.rfind(':');
+    if (colon != string::npos) {
+        size_t dot = display.find('.', colon);
+        if (dot != string::npos) {
+            display.erase(dot);
+        }
+    }
+    std::replace(display.begin(), display.end(), '/', '_');
+    return string(runtimeDir) + "/" HERBST_IPC_SOCKET_DIR "/"
+        HERBST_IPC_SOCKET_PREFIX + display;
+}
+
+//! listen on the given path. Print a warning and return false on failure.
+bool IpcSocketServer::listen(const string& path)
+{
+    close();
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        HSWarning("Not listening on \"%s\": path too long\n", path.c_str());
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    // the directory is only accessible by the current user
+    string directory = path.substr(0, path.rfind('/'));
+    if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        HSWarning("Cannot create directory \"%s\": %s\n",
+                  directory.c_str(), strerror(errno));
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        HSWarning("Cannot create socket: %s\n", strerror(errno));
+        return false;
+    }
+    if (socketIsInUse(address)) {
+        HSWarning("Not listening on \"%s\": another instance listens on it\n",
+                  path.c_str());
+        ::close(fd);
+        return false;
+    }
+    // remove the stale socket of a previous instance (e.g. after a crash)
+    unlink(path.c_str());
+    struct stat socketStat;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0
+        || stat(path.c_str(), &socketStat) != 0)
+    {
+        HSWarning("Cannot listen on \"%s\": %s\n", path.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    listenFd_ = fd;
+    path_ = path;
+    socketDevice_ = socketStat.st_dev;
+    socketInode_ = socketStat.st_ino;
+    return true;
+}
+
+//! whether a server accepts connections on the given address
+bool IpcSocketServer::socketIsInUse(const struct sockaddr_un& address)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    int status = connect(fd, reinterpret_cast<const struct sockaddr*>(&address),
+                         sizeof(address));
+    int error = errno;
+    ::close(fd);
+    // if the backlog of the server is full, connect() fails with EAGAIN.
+    // Otherwise, the socket does not exist or nobody listens on it anymore.
+    return status == 0 || wouldBlock(error);
+}
+
+//! close all connections and remove the socket
+void IpcSocketServer::close()
+{
+    for (auto& connection : connections_) {
+        ::close(connection->fd);
+    }
+    connections_.clear();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        // only remove the socket if it was not replaced by another instance
+        struct stat socketStat;
+        if (stat(path_.c_str(), &socketStat) == 0
+            && socketStat.st_dev == socketDevice_
+            && socketStat.st_ino == socketInode_)
+        {
+            unlink(path_.c_str());
+        }
+        listenFd_ = -1;
+        path_ = "";
+    }
+}
+
+int IpcSocketServer::fillFdSets(fd_set* readFds, fd_set* writeFds) const
+{
+    if (listenFd_ < 0) {
+        return -1;
+    }
+    int maxFd = listenFd_;
+    FD_SET(listenFd_, readFds);
+    for (const auto& connection : connections_) {
+        if (connection->closed) {
+            continue;
+        }
+        if (!connection->eof) {
+            FD_SET(connection->fd, readFds);
+        }
+        if (!connection->writeBuffer.empty()) {
+            FD_SET(connection->fd, writeFds);
+        }
+        maxFd = std::max(maxFd, connection->fd);
+    }
+    return maxFd;
+}
+
+void IpcSocketServer::handleFdSets(const fd_set* readFds, const fd_set* writeFds,
+                                   CallHandler callback)
+{
+    if (listenFd_ < 0) {
+        return;
+    }
+    // handle the existing connections before accepting new ones, because
+    // the new ones are not in the fd sets
+    for (size_t i = 0; i < connections_.size(); i++) {
+        Connection& connection = *connections_[i];
+        if (FD_ISSET(connection.fd, writeFds)) {
+            writeReplies(connection);
+        }
+        if (!connection.closed && !connection.eof && FD_ISSET(connection.fd, readFds)) {
+            readRequests(connection, callback);
+        }
+        closeIfFinished(connection);
+    }
+    if (FD_ISSET(listenFd_, readFds)) {
+        acceptConnections();
+    }
+    // drop closed connections
+    connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
+        [](const std::unique_ptr<Connection>& connection) {
+            if (connection->closed) {
+                ::close(connection->fd);
+            }
+            return connection->closed;
+        }), connections_.end());
+}
+
+void IpcSocketServer::flush()
+{
+    for (auto& connection : connections_) {
+        if (!connection->closed && !connection->writeBuffer.empty()) {
+            writeReplies(*connection);
+            closeIfFinished(*connection);
+        }
+    }
+}
+
+/** close the connection if the client has hung up and does not wait for
+ * further replies. A hook stream never ends by itself, so a subscriber
+ * that has hung up does not get any further hooks.
+ */
+void IpcSocketServer::closeIfFinished(Connection& connection)
+{
+    if (connection.eof && (connection.subscribed || connection.writeBuffer.empty())) {
+        connection.closed = true;
+    }
+}
+
+void IpcSocketServer::acceptConnections()
+{
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN if there are no more pending connections
+            return;
+        }
+        auto connection = make_unique<Connection>();
+        connection->fd = fd;
+        connections_.push_back(std::move(connection));
+    }
+}
+
+//! read all available data and run all requests that are complete
+void IpcSocketServer::readRequests(Connection& connection, CallHandler callback)
+{
+    char buf[4096];
+    while (true) {
+        ssize_t size = read(connection.fd, buf, sizeof(buf));
+        if (size > 0) {
+            connection.readBuffer.append(buf, static_cast<size_t>(size));
+            continue;
+        }
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size == 0) {
+            // the client does not send any further requests, but
+            // possibly still waits for the replies
+            connection.eof = true;
+        } else if (!wouldBlock(errno)) {
+            connection.closed = true;
+            return;
+        }
+        break;
+    }
+    size_t offset = 0;
+    while (connection.readBuffer.size() - offset >= sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, connection.readBuffer.data() + offset, sizeof(length));
+        length = ntohl(length);
+        if (length > HERBST_IPC_SOCKET_MAX_MESSAGE) {
+            HSWarning("Closing ipc connection: message too long\n");
+            connection.closed = true;
+            return;
+        }
+        if (connection.readBuffer.size() - offset - sizeof(length) < length) {
+            // the message is not complete yet
+            break;
+        }
+        offset += sizeof(length);
+        // the arguments are null-terminated
+        vector<string> arguments;
+        size_t end = offset + length;
+        while (offset < end) {
+            size_t terminator = connection.readBuffer.find('\0', offset);
+            if (terminator == string::npos || terminator >= end) {
+                terminator = end;
+            }
+            arguments.push_back(connection.readBuffer.substr(offset, terminator - offset));
+            offset = terminator + 1;
+        }
+        offset = end;
+        if (connection.subscribed) {
+            // a hook stream does not accept any further requests
+            continue;
+        }
+        if (connection.writeBuffer.size() > maxPendingReplyBytes_) {
+            writeReplies(connection);
+        }
+        if (connection.writeBuffer.size() > maxPendingReplyBytes_) {
+            // the client sends requests but does not read the replies
+            HSWarning("Closing ipc connection: too many unread replies\n");
+            connection.closed = true;
+            connection.readBuffer.clear();
+            connection.writeBuffer.clear();
+            return;
+        }
+        if (!arguments.empty() && arguments[0].empty()) {
+            controlRequest(connection, arguments);
+            continue;
+        }
+        auto result = callback(arguments);
+        appendReply(connection.writeBuffer, result.first, result.second);
+        unsyncedReplies_ = true;
+    }
+    connection.readBuffer.erase(0, offset);
+}
+
+void IpcSocketServer::writeReplies(Connection& connection)
+{
+    if (unsyncedReplies_ && !connection.writeBuffer.empty()) {
+        unsyncedReplies_ = false;
+        if (syncHandler_) {
+            syncHandler_();
+        }
+    }
+    while (!connection.writeBuffer.empty()) {
+        ssize_t size = send(connection.fd, connection.writeBuffer.data(),
+                            connection.writeBuffer.size(), MSG_NOSIGNAL);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!wouldBlock(errno)) {
+                connection.closed = true;
+                connection.writeBuffer.clear();
+            }
+            // otherwise, the rest is written when the socket is writable
+            return;
+        }
+        connection.writeBuffer.erase(0, static_cast<size_t>(size));
+    }
+}
+
+//! append a message with the reply to a request to the given buffer
+void IpcSocketServer::appendReply(string& buffer, int status, const string& output)
+{
+    // the reply consists of the exit status and the output
+    uint32_t replyLength = htonl(static_cast<uint32_t>(sizeof(uint32_t) + output.size()));
+    uint32_t replyStatus = htonl(static_cast<uint32_t>(status));
+    buffer.append(reinterpret_cast<char*>(&replyLength), sizeof(replyLength));
+    buffer.append(reinterpret_cast<char*>(&replyStatus), sizeof(replyStatus));
+    buffer += output;
+}
+
+//! the message of a hook on a hook stream
+string IpcSocketServer::hookMessage(uint64_t sequence, const vector<string>& args)
+{
+    size_t length = 2 * sizeof(uint32_t);
+    for (const auto& arg : args) {
+        length += arg.size() + 1;
+    }
+    uint32_t header[3] = {
+        htonl(static_cast<uint32_t>(length)),
+        htonl(static_cast<uint32_t>(sequence >> 32)),
+        htonl(static_cast<uint32_t>(sequence & 0xffffffff)),
+    };
+    string message(reinterpret_cast<char*>(header), sizeof(header));
+    message.reserve(sizeof(uint32_t) + length);
+    for (const auto& arg : args) {
+        message += arg;
+        message.push_back('\0');
+    }
+    return message;
+}
+
+void IpcSocketServer::controlRequest(Connection& connection, const vector<string>& arguments)
+{
+    if (arguments.size() < 3 || arguments[1] != HERBST_IPC_SOCKET_SUBSCRIBE) {
+        appendReply(connection.writeBuffer, HERBST_INVALID_ARGUMENT,
+                    "Unknown control request\n");
+        return;
+    }
+    uint64_t since = nextHookSequence_;
+    if (!arguments[2].empty()) {
+        try {
+            size_t end = 0;
+            since = std::stoull(arguments[2], &end);
+            if (end != arguments[2].size()) {
+                throw std::invalid_argument(arguments[2]);
+            }
+        } catch (const std::exception&) {
+            appendReply(connection.writeBuffer, HERBST_INVALID_ARGUMENT,
+                        "Invalid sequence number \"" + arguments[2] + "\"\n");
+            return;
+        }
+    }
+    vector<std::shared_ptr<const RegexEngine>> hookFilter;
+    for (size_t i = 3; i < arguments.size(); i++) {
+        try {
+            hookFilter.push_back(RegexEngine::compile(arguments[i]));
+        } catch (const std::exception& e) {
+            appendReply(connection.writeBuffer, HERBST_INVALID_ARGUMENT,
+                        "Cannot parse regex \"" + arguments[i] + "\": "
+                        + e.what() + "\n");
+            return;
+        }
+    }
+    connection.subscribed = true;
+    connection.hookFilter = hookFilter;
+    appendReply(connection.writeBuffer, 0, std::to_string(nextHookSequence_));
+    // resume with the hooks from the backlog. The ones before it are lost.
+    since = std::max(since, static_cast<uint64_t>(1));
+    uint64_t oldest = hookBacklog_.empty() ? nextHookSequence_ : hookBacklog_.front().sequence;
+    if (since < oldest) {
+        connection.lostHooks += oldest - since;
+        hooksDropped_ += oldest - since;
+    }
+    for (const auto& hook : hookBacklog_) {
+        if (hook.sequence >= since && filterMatches(connection, hook.args)) {
+            sendHook(connection, hook);
+        }
+    }
+}
+
+bool IpcSocketServer::filterMatches(const Connection& connection, const vector<string>& args)
+{
+    for (size_t i = 0; i < connection.hookFilter.size() && i < args.size(); i++) {
+        // the filter matches anywhere in the argument, like regexec()
+        // does for the filters of herbstclient
+        if (!connection.hookFilter[i]->search(args[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IpcSocketServer::sendHook(Connection& connection, const Hook& hook)
+{
+    if (connection.lostHooks > 0) {
+        // tell the subscriber how many hooks it has missed
+        connection.writeBuffer += hookMessage(connection.lostHooks, {});
+        connection.lostHooks = 0;
+    }
+    connection.writeBuffer += hook.message;
+    hooksDelivered_++;
+}
+
+void IpcSocketServer::emitHook(const vector<string>& args)
+{
+    Hook hook;
+    hook.sequence = nextHookSequence_++;
+    hook.args = args;
+    hook.message = hookMessage(hook.sequence, args);
+    for (auto& connection : connections_) {
+        if (!connection->subscribed || connection->closed
+            || !filterMatches(*connection, args))
+        {
+            continue;
+        }
+        if (connection->writeBuffer.size() > maxPendingHookBytes_) {
+            // the subscriber does not keep up. It is told about the lost
+            // hooks once it has caught up, and it can resume from the backlog
+            connection->lostHooks++;
+            hooksDropped_++;
+            continue;
+        }
+        sendHook(*connection, hook);
+    }
+    hookBacklog_.push_back(std::move(hook));
+    if (hookBacklog_.size() > hookBacklogSize_) {
+        hookBacklog_.pop_front();
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef __HERBSTLUFT_IPC_SOCKET_SERVER_H_
+#define __HERBSTLUFT_IPC_SOCKET_SERVER_H_
+
+#include <sys/select.h>
+#include <sys/types.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class RegexEngine;
+struct sockaddr_un;
+
+/**
+ * The IPC transport on a unix socket. In contrast to the transport via X
+ * windows, a connection is persistent and can carry arbitrarily many
+ * requests, which are answered in the order they were sent. The framing of
+ * the messages is described in ipc-protocol.h.
+ *
+ * The server does not block: all sockets are non-blocking and the main loop
+ * only hands over those sockets that are ready.
+ *
+ * Connections can subscribe to the hooks. Every hook gets a sequence number
+ * and the most recent hooks are kept in a backlog, such that subscribers can
+ * resume the stream after a reconnect. Subscribers only receive the hooks
+ * matching their filter, so they are not woken up by all the others.
+ */
+class IpcSocketServer {
+public:
+    using CallHandler = std::function<std::pair<int,std::string>(const std::vector<std::string>&)>;
+    IpcSocketServer() = default;
+    ~IpcSocketServer();
+
+    static std::string socketPath(const std::string& displayName);
+    bool listen(const std::string& path);
+    void close();
+    const std::string& path() const { return path_; }
+
+    //! add all sockets to the given fd sets and return the highest fd
+    int fillFdSets(fd_set* readFds, fd_set* writeFds) const;
+    //! handle all sockets that are ready according to the given fd sets
+    void handleFdSets(const fd_set* readFds, const fd_set* writeFds,
+                      CallHandler callback);
+    //! write the pending replies, if possible without blocking
+    void flush();
+    /** set the function that makes the effects of the requests visible,
+     * e.g. to the X server. It is called once before the replies to new
+     * requests are written.
+     */
+    void setSyncHandler(std::function<void()> handler) { syncHandler_ = handler; }
+
+    //! send a hook to all subscribers and keep it in the backlog
+    void emitHook(const std::vector<std::string>& args);
+    uint64_t hooksEmitted() const { return nextHookSequence_ - 1; }
+    unsigned long hooksDelivered() const { return hooksDelivered_; }
+    unsigned long hooksDropped() const { return hooksDropped_; }
+
+    //! the number of hooks that are kept for resuming subscribers
+    static const size_t hookBacklogSize_ = 1000;
+    //! the maximum size of the pending hooks of a subscriber. If it does
+    //not read them, further hooks are dropped
+    static const size_t maxPendingHookBytes_ = 1024 * 1024;
+    //! the maximum size of the pending replies of a connection. If the
+    //client sends further requests without reading them, it is dropped
+    static const size_t maxPendingReplyBytes_ = maxPendingHookBytes_;
+private:
+    class Connection {
+    public:
+        int fd = -1;
+        std::string readBuffer;
+        std::string writeBuffer;
+        //! whether the client will not send any further requests
+        bool eof = false;
+        //! whether the connection can be dropped
+        bool closed = false;
+        //! whether the connection is a hook stream
+        bool subscribed = false;
+        //! the n'th regex has to match the n'th argument of a hook
+        std::vector<std::shared_ptr<const RegexEngine>> hookFilter;
+        //! the number of hooks that were lost since the last message
+        uint64_t lostHooks = 0;
+    };
+    class Hook {
+    public:
+        uint64_t sequence;
+        std::vector<std::string> args;
+        //! the encoded message on the hook stream
+        std::string message;
+    };
+    static bool socketIsInUse(const struct sockaddr_un& address);
+    void acceptConnections();
+    void readRequests(Connection& connection, CallHandler callback);
+    void writeReplies(Connection& connection);
+    static void closeIfFinished(Connection& connection);
+    void controlRequest(Connection& connection, const std::vector<std::string>& arguments);
+    static void appendReply(std::string& buffer, int status, const std::string& output);
+    static std::string hookMessage(uint64_t sequence, const std::vector<std::string>& args);
+    static bool filterMatches(const Connection& connection, const std::vector<std::string>& args);
+    void sendHook(Connection& connection, const Hook& hook);
+
+    int listenFd_ = -1;
+    std::string path_;
+    //! the identity of the socket file, to not remove the one of another instance
+    dev_t socketDevice_ = 0;
+    ino_t socketInode_ = 0;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::function<void()> syncHandler_;
+    //! whether requests were handled since the last call of the sync handler
+    bool unsyncedReplies_ = false;
+    uint64_t nextHookSequence_ = 1;
+    //! the most recent hooks
+    std::deque<Hook> hookBacklog_;
+    unsigned long hooksDelivered_ = 0;
+    unsigned long hooksDropped_ = 0;
+};
+
+#endif
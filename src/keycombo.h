@@ -75,3 +75,13 @@ public:
 
     KeySym keysym = {};
 };
+
+namespace std {
+    //! hash KeyCombo objects in the same way as they are compared
+    template<> struct hash<KeyCombo> {
+        size_t operator()(const KeyCombo& combo) const {
+            return hash<unsigned long>()(combo.keysym)
+                    ^ (hash<unsigned int>()(combo.modifiers_) << 1);
+        }
+    };
+}
@@ -1,7 +1,9 @@
 #include "keymanager.h"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <utility>
 
@@ -16,14 +18,126 @@
 #include "utils.h"
 
 using std::endl;
+using std::make_shared;
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
+
+KeyManager::KeyManager(TimerQueue& timers)
+    : mode_(this, "mode", "")
+    , modes_(*this, "modes")
+    , timers_(timers)
+{
+    mode_.setDoc("the name of the active key mode, or the empty string "
+                 "if the default key bindings are active");
+    modes_.setChildDoc("the key modes, which have their own key bindings. A "
+                  "key mode is created by the first binding added to it "
+                  "with \'keybind --mode=NAME\' and entered with "
+                  "the \'keymode\' command.");
+}
 
 KeyManager::~KeyManager() {
+    if (modeTimer_.has_value()) {
+        timers_.cancel(modeTimer_.value());
+    }
     xKeyGrabber_.ungrabAll();
 }
 
+/*!
+ * If the next argument is --mode=NAME, consume it and set table and mode
+ * to the key table of that mode. If the mode does not exist yet, it is
+ * created if 'create' is set. Otherwise, table is set to the default key
+ * table and mode to nullptr.
+ *
+ * \return false if the mode name is invalid or if there is no such mode
+ */
+bool KeyManager::parseModeFlag(Input& input, Output output, bool create,
+                               KeyTable*& table, KeyMode*& mode)
+{
+    static const string prefix = "--mode=";
+    table = &defaultTable_;
+    mode = nullptr;
+    if (input.empty() || input.front().substr(0, prefix.size()) != prefix) {
+        return true;
+    }
+    string name = input.front().substr(prefix.size());
+    input.shift();
+    if (name.empty()) {
+        // the default mode
+        return true;
+    }
+    if (name.find('.') != string::npos) {
+        output << input.command() << ": the mode name \"" << name
+               << "\" must not contain a dot\n";
+        return false;
+    }
+    auto it = keyModes_.find(name);
+    if (it != keyModes_.end()) {
+        mode = it->second.get();
+    } else if (create) {
+        mode = addKeyMode(name);
+    } else {
+        output << input.command() << ": there is no key mode \""
+               << name << "\"\n";
+        return false;
+    }
+    table = &mode->table_;
+    return true;
+}
+
+KeyManager::KeyMode* KeyManager::addKeyMode(const string& name)
+{
+    auto& entry = keyModes_[name];
+    entry = make_unique<KeyMode>(name);
+    KeyMode* mode = entry.get();
+    // changes of the active mode take effect immediately
+    mode->timeout_.changed().connect([this, mode]() {
+        if (activeMode_ == mode) {
+            startKeyModeTimeout();
+        }
+    });
+    mode->escape_.changed().connect([this, mode]() {
+        if (activeMode_ == mode) {
+            if (grabbedEscape_.has_value()) {
+                xKeyGrabber_.ungrabKeyCombo(grabbedEscape_.value());
+                grabbedEscape_ = {};
+            }
+            grabEscape();
+        }
+    });
+    modes_.addChild(mode, name);
+    return mode;
+}
+
+//! complete the --mode= flag of the key binding commands
+void KeyManager::completeModeFlag(Completion& complete)
+{
+    for (const auto& it : keyModes_) {
+        complete.full("--mode=" + it.first);
+    }
+}
+
+//! the number of arguments taken by a --mode= flag
+size_t KeyManager::modeFlagCount(Completion& complete)
+{
+    if (complete > 0 && Completion::prefixOf("--mode=", complete[0])) {
+        return 1;
+    }
+    return 0;
+}
+
+KeyManager::KeyTable& KeyManager::activeTable()
+{
+    return activeMode_ ? activeMode_->table_ : defaultTable_;
+}
+
 int KeyManager::addKeybindCommand(Input input, Output output) {
+    KeyTable* table;
+    KeyMode* mode;
+    if (!parseModeFlag(input, output, true, table, mode)) {
+        return HERBST_INVALID_ARGUMENT;
+    }
     if (input.size() < 2) {
         return HERBST_NEED_MORE_ARGS;
     }
@@ -42,17 +156,22 @@ int KeyManager::addKeybindCommand(Input input, Output output) {
     newBinding->cmd = {input.begin(), input.end()};
 
     // newBinding->cmd is not empty because the size before the input.shift() was >= 2
-    if (!Commands::commandExists(newBinding->cmd[0])) {
+    auto commandTable = Commands::get();
+    auto command = commandTable->find(newBinding->cmd[0]);
+    if (command == commandTable->end()) {
         output << input.command() << ": the command \""
                << newBinding->cmd[0] << "\" does not exist."
                << " Did you forget \"spawn\"?\n";
         return HERBST_COMMAND_NOT_FOUND;
     }
+    // the command table is never modified, so the binding stays valid
+    newBinding->command = &command->second;
 
     // Make sure there is no existing binding with same keysym/modifiers
-    removeKeyBinding(newBinding->keyCombo);
+    table->remove(newBinding->keyCombo);
 
-    if (currentKeyMask_.allowsBinding(newBinding->keyCombo)
+    if (table == &activeTable()
+        && currentKeyMask_.allowsBinding(newBinding->keyCombo)
         && currentKeysInactive_.allowsBinding(newBinding->keyCombo))
     {
         // Grab for events on this keycode
@@ -61,15 +180,26 @@ int KeyManager::addKeybindCommand(Input input, Output output) {
     }
 
     // Add keybinding to list
-    binds.push_back(std::move(newBinding));
+    table->add(std::move(newBinding));
 
     ensureKeyMask();
 
     return HERBST_EXIT_SUCCESS;
 }
 
-int KeyManager::listKeybindsCommand(Output output) const {
-    for (auto& binding : binds) {
+int KeyManager::listKeybindsCommand(Input input, Output output) {
+    KeyTable* table;
+    KeyMode* mode;
+    if (!parseModeFlag(input, output, false, table, mode)) {
+        return HERBST_INVALID_ARGUMENT;
+    }
+    string arg;
+    if (input >> arg) {
+        output << input.command() << ": unknown argument \""
+               << arg << "\"\n";
+        return HERBST_INVALID_ARGUMENT;
+    }
+    for (auto& binding : table->binds) {
         // add key combo
         output << binding->keyCombo.str();
         // add associated command
@@ -79,15 +209,41 @@ int KeyManager::listKeybindsCommand(Output output) const {
     return 0;
 }
 
+void KeyManager::listKeybindsCompletion(Completion& complete)
+{
+    if (complete == 0) {
+        completeModeFlag(complete);
+    } else {
+        complete.none();
+    }
+}
+
 int KeyManager::removeKeybindCommand(Input input, Output output) {
+    KeyTable* table;
+    KeyMode* mode;
+    if (!parseModeFlag(input, output, false, table, mode)) {
+        return HERBST_INVALID_ARGUMENT;
+    }
     string arg;
     if (!(input >> arg)) {
         return HERBST_NEED_MORE_ARGS;
     }
 
     if (arg == "--all" || arg == "-F") {
-        binds.clear();
-        xKeyGrabber_.ungrabAll();
+        if (mode) {
+            // removing all bindings of a mode removes the mode itself
+            if (activeMode_ == mode) {
+                enterKeyMode(nullptr);
+            }
+            string name = mode->name_();
+            modes_.removeChild(name);
+            keyModes_.erase(name);
+        } else {
+            table->clear();
+            if (!activeMode_) {
+                xKeyGrabber_.ungrabAll();
+            }
+        }
     } else {
         KeyCombo comboToRemove = {};
         try {
@@ -98,8 +254,10 @@ int KeyManager::removeKeybindCommand(Input input, Output output) {
         }
 
         // Remove binding (or moan if none was found)
-        if (removeKeyBinding(comboToRemove)) {
-            regrabAll();
+        if (table->remove(comboToRemove)) {
+            if (table == &activeTable()) {
+                regrabAll();
+            }
         } else {
             output << input.command() << ": Key \"" << arg << "\" is not bound\n";
         }
@@ -109,36 +267,148 @@ int KeyManager::removeKeybindCommand(Input input, Output output) {
 }
 
 void KeyManager::addKeybindCompletion(Completion &complete) {
+    size_t offset = modeFlagCount(complete);
     if (complete == 0) {
+        completeModeFlag(complete);
+    }
+    if (complete == offset) {
         KeyCombo::complete(complete);
-    } else {
-        complete.completeCommands(1);
+    } else if (complete > offset) {
+        complete.completeCommands(offset + 1);
     }
 }
 
 void KeyManager::removeKeybindCompletion(Completion &complete) {
+    size_t offset = modeFlagCount(complete);
     if (complete == 0) {
+        completeModeFlag(complete);
+    }
+    if (complete == offset) {
         complete.full({ "-F", "--all" });
 
-        for (auto& binding : binds) {
+        KeyTable* table = &defaultTable_;
+        if (offset > 0) {
+            string modeName = complete[0].substr(string("--mode=").size());
+            auto it = keyModes_.find(modeName);
+            if (it == keyModes_.end()) {
+                return;
+            }
+            table = &it->second->table_;
+        }
+        for (auto& binding : table->binds) {
             complete.full(binding->keyCombo.str());
         }
+    } else if (complete > offset) {
+        complete.none();
     }
 }
 
-void KeyManager::handleKeyPress(XKeyEvent* ev) const {
+int KeyManager::keymodeCommand(Input input, Output output)
+{
+    string name;
+    if (!(input >> name) || name.empty()) {
+        enterKeyMode(nullptr);
+        return HERBST_EXIT_SUCCESS;
+    }
+    auto it = keyModes_.find(name);
+    if (it == keyModes_.end()) {
+        output << input.command() << ": there is no key mode \""
+               << name << "\"\n";
+        return HERBST_INVALID_ARGUMENT;
+    }
+    enterKeyMode(it->second.get());
+    return HERBST_EXIT_SUCCESS;
+}
+
+void KeyManager::keymodeCompletion(Completion& complete)
+{
+    if (complete == 0) {
+        for (const auto& it : keyModes_) {
+            complete.full(it.first);
+        }
+    } else {
+        complete.none();
+    }
+}
+
+void KeyManager::handleKeyPress(XKeyEvent* ev) {
     KeyCombo pressed = xKeyGrabber_.xEventToKeyCombo(ev);
 
-    auto found = std::find_if(binds.begin(), binds.end(),
-            [=](const unique_ptr<KeyBinding> &other) {
-                return pressed == other->keyCombo;
-            });
-    if (found != binds.end()) {
-        // execute the bound command
-        std::ostringstream discardedOutput;
-        auto& cmd = (*found)->cmd;
-        Input input(cmd.front(), {cmd.begin() + 1, cmd.end()});
-        Commands::call(input, discardedOutput);
+    const KeyBinding* binding = activeTable().find(pressed);
+    if (!binding) {
+        if (grabbedEscape_.has_value() && grabbedEscape_.value() == pressed) {
+            enterKeyMode(nullptr);
+        }
+        return;
+    }
+    // copy the command, because leaving the key mode or the command
+    // itself might remove the binding
+    const CommandBinding* command = binding->command;
+    auto& cmd = binding->cmd;
+    Input input(cmd.front(), {cmd.begin() + 1, cmd.end()});
+    if (activeMode_) {
+        if (activeMode_->sticky_()) {
+            // restart the timeout
+            enterKeyMode(activeMode_);
+        } else {
+            enterKeyMode(nullptr);
+        }
+    }
+    // execute the bound command
+    std::ostringstream discardedOutput;
+    CommandTable::callBinding(*command, input, discardedOutput);
+}
+
+/*!
+ * Make the bindings of the given mode (or of the default mode if nullptr)
+ * the active ones. The grabs are replaced in one step, i.e. without
+ * ungrabbing the bindings of the previous mode one by one.
+ */
+void KeyManager::enterKeyMode(KeyMode* mode)
+{
+    if (mode == activeMode_) {
+        startKeyModeTimeout();
+        return;
+    }
+    xKeyGrabber_.ungrabAll();
+    for (auto& binding : activeTable().binds) {
+        binding->grabbed = false;
+    }
+    activeTable().grabbedBindings = {};
+    grabbedEscape_ = {};
+    activeMode_ = mode;
+    mode_ = mode ? mode->name_() : "";
+    startKeyModeTimeout();
+    setActiveKeyMask(currentKeyMask_, currentKeysInactive_);
+    grabEscape();
+}
+
+//! (re)start the timeout of the active key mode
+void KeyManager::startKeyModeTimeout()
+{
+    if (modeTimer_.has_value()) {
+        timers_.cancel(modeTimer_.value());
+        modeTimer_ = {};
+    }
+    if (activeMode_ && activeMode_->timeout_() > 0) {
+        modeTimer_ = timers_.schedule(std::chrono::milliseconds(activeMode_->timeout_()),
+                                      [this]() {
+            modeTimer_ = {};
+            enterKeyMode(nullptr);
+        });
+    }
+}
+
+//! grab the escape key of the active mode, if it does not have a binding
+void KeyManager::grabEscape()
+{
+    if (!activeMode_ || grabbedEscape_.has_value()) {
+        return;
+    }
+    auto escape = activeMode_->escapeCombo();
+    if (escape.has_value() && !activeMode_->table_.find(escape.value())) {
+        xKeyGrabber_.grabKeyCombo(escape.value());
+        grabbedEscape_ = escape;
     }
 }
 
@@ -148,12 +418,14 @@ void KeyManager::regrabAll() {
      // Remove all current grabs:
     xKeyGrabber_.ungrabAll();
 
-    for (auto& binding : binds) {
+    for (auto& binding : activeTable().binds) {
         // grab precisely those again, that have been grabbed before
         if (binding->grabbed) {
             xKeyGrabber_.grabKeyCombo(binding->keyCombo);
         }
     }
+    grabbedEscape_ = {};
+    grabEscape();
 }
 
 /*!
@@ -190,19 +462,31 @@ void KeyManager::ensureKeyMask(const Client* client) {
     setActiveKeyMask(newKeyMask, newKeysInactive);
 }
 
-//! Apply new keymask by grabbing/ungrabbing current bindings accordingly
+/*!
+ * Apply new keymask by grabbing/ungrabbing current bindings accordingly.
+ * Only the bindings whose state differs from the previously applied mask
+ * are touched.
+ */
 void KeyManager::setActiveKeyMask(const KeyMask& keyMask, const KeyMask& keysInactive) {
-    for (auto& binding : binds) {
-        auto name = binding->keyCombo.str();
-        bool isAllowed = keysInactive.allowsBinding(binding->keyCombo)
-                         && keyMask.allowsBinding(binding->keyCombo);
-        if (isAllowed && !binding->grabbed) {
-            xKeyGrabber_.grabKeyCombo(binding->keyCombo);
-            binding->grabbed = true;
-        } else if (!isAllowed && binding->grabbed) {
-            xKeyGrabber_.ungrabKeyCombo(binding->keyCombo);
-            binding->grabbed = false;
+    KeyTable& table = activeTable();
+    auto allowed = table.allowedBindings(keyMask, keysInactive);
+    auto previous = table.grabbedBindings;
+    if (allowed != previous) {
+        for (size_t i = 0; i < table.binds.size(); i++) {
+            bool isAllowed = (*allowed)[i];
+            if (previous && (*previous)[i] == isAllowed) {
+                continue;
+            }
+            auto& binding = table.binds[i];
+            if (isAllowed && !binding->grabbed) {
+                xKeyGrabber_.grabKeyCombo(binding->keyCombo);
+                binding->grabbed = true;
+            } else if (!isAllowed && binding->grabbed) {
+                xKeyGrabber_.ungrabKeyCombo(binding->keyCombo);
+                binding->grabbed = false;
+            }
         }
+        table.grabbedBindings = allowed;
     }
     currentKeyMask_ = keyMask;
     currentKeysInactive_ = keysInactive;
@@ -213,30 +497,140 @@ void KeyManager::clearActiveKeyMask() {
     setActiveKeyMask({}, {});
 }
 
+void KeyManager::KeyTable::add(unique_ptr<KeyBinding> binding)
+{
+    bindsByCombo_[binding->keyCombo] = binding.get();
+    binds.push_back(std::move(binding));
+    bindingsChanged();
+}
+
 /*!
  * Removes a given key combo from the list of bindings (no ungrabbing)
  *
  * \return True if a matching binding was found and removed
  * \return False if no matching binding was found
  */
-bool KeyManager::removeKeyBinding(const KeyCombo& comboToRemove) {
+bool KeyManager::KeyTable::remove(const KeyCombo& comboToRemove) {
     // Find binding to remove
-    auto removeIter = binds.begin();
-    for (; removeIter != binds.end(); removeIter++) {
-        if (comboToRemove == (*removeIter)->keyCombo) {
-            break;
-        }
-    }
-
-    if (removeIter == binds.end()) {
+    auto found = bindsByCombo_.find(comboToRemove);
+    if (found == bindsByCombo_.end()) {
         return False; // no matching binding found
     }
+    KeyBinding* binding = found->second;
+    bindsByCombo_.erase(found);
 
     // Remove binding
+    auto removeIter = std::find_if(binds.begin(), binds.end(),
+            [binding](const unique_ptr<KeyBinding>& other) {
+                return other.get() == binding;
+            });
     binds.erase(removeIter);
+    bindingsChanged();
     return True;
 }
 
+void KeyManager::KeyTable::clear()
+{
+    binds.clear();
+    bindsByCombo_.clear();
+    bindingsChanged();
+}
+
+//! forget everything that was derived from the list of bindings
+void KeyManager::KeyTable::bindingsChanged()
+{
+    allowedBindingsCache_.clear();
+    grabbedBindings = {};
+}
+
+//! the binding for the given key combo or nullptr
+KeyManager::KeyBinding* KeyManager::KeyTable::find(const KeyCombo& combo) const
+{
+    auto found = bindsByCombo_.find(combo);
+    if (found == bindsByCombo_.end()) {
+        return nullptr;
+    }
+    return found->second;
+}
+
+/*!
+ * Return which bindings are allowed by the given keymask and keys_inactive
+ * regexes. This is computed only once for each of the recently used pairs
+ * of regexes, as long as the bindings do not change.
+ */
+shared_ptr<const vector<bool>> KeyManager::KeyTable::allowedBindings(const KeyMask& keyMask,
+                                                                     const KeyMask& keysInactive)
+{
+    string keyMaskStr = keyMask.str();
+    string keysInactiveStr = keysInactive.str();
+    auto cached = std::find_if(allowedBindingsCache_.begin(), allowedBindingsCache_.end(),
+            [&](const AllowedBindings& entry) {
+                return entry.keyMask == keyMaskStr
+                    && entry.keysInactive == keysInactiveStr;
+            });
+    if (cached != allowedBindingsCache_.end()) {
+        // move it to the front
+        std::rotate(allowedBindingsCache_.begin(), cached, cached + 1);
+        return allowedBindingsCache_.front().allowed;
+    }
+    auto allowed = make_shared<vector<bool>>();
+    allowed->reserve(binds.size());
+    for (auto& binding : binds) {
+        auto name = binding->keyCombo.str();
+        allowed->push_back(keysInactive.allowsBinding(name)
+                           && keyMask.allowsBinding(name));
+    }
+    if (allowedBindingsCache_.size() >= allowedBindingsCacheSize_) {
+        allowedBindingsCache_.pop_back();
+    }
+    allowedBindingsCache_.insert(allowedBindingsCache_.begin(),
+                                 { keyMaskStr, keysInactiveStr, allowed });
+    return allowed;
+}
+
+KeyManager::KeyMode::KeyMode(const string& name)
+    : name_(this, "name", name)
+    , sticky_(this, "sticky", false)
+    , timeout_(this, "timeout", 0)
+    , escape_(this, "escape", "Escape", &KeyMode::validateEscape)
+{
+    sticky_.setWritable();
+    timeout_.setWritable();
+    name_.setDoc("the name of the key mode");
+    sticky_.setDoc("whether the key mode stays active after one of its "
+                   "bindings was pressed. Otherwise, the default key "
+                   "bindings are active again afterwards.");
+    timeout_.setDoc("the number of milliseconds after which the default "
+                    "key bindings are active again, or 0 for no timeout. "
+                    "In a sticky mode, every key press restarts the timeout.");
+    escape_.setDoc("the key that returns to the default key bindings, "
+                   "unless the key mode has a binding for it. If empty, "
+                   "there is no such key.");
+    setDoc("a key mode with its own key bindings");
+}
+
+string KeyManager::KeyMode::validateEscape(string escape)
+{
+    if (escape.empty()) {
+        return "";
+    }
+    try {
+        KeyCombo::fromString(escape);
+    } catch (std::exception& error) {
+        return error.what();
+    }
+    return "";
+}
+
+//! the key combo of the escape attribute, if set
+std::experimental::optional<KeyCombo> KeyManager::KeyMode::escapeCombo() const
+{
+    if (escape_().empty()) {
+        return {};
+    }
+    return KeyCombo::fromString(escape_());
+}
+
 
 /*!
  * Returns true if the string representation of the KeyCombo matches
@@ -255,13 +649,22 @@ KeyManager::KeyMask::KeyMask()
 }
 
 bool KeyManager::KeyMask::allowsBinding(const KeyCombo &combo) const
+{
+    if (regex_.empty()) {
+        return true;
+    }
+    return allowsBinding(combo.str());
+}
+
+//! whether the binding with the given string representation is allowed
+bool KeyManager::KeyMask::allowsBinding(const string& comboString) const
 {
     if (regex_.empty()) {
         // an unset keymask allows every binding, regardless of
         // the 'negated_' flag
         return true;
     } else {
-        bool match = regex_.matches(combo.str());
+        bool match = regex_.matches(comboString);
         if (negated_) {
             // only allow keybindings that don't match
             return !match;
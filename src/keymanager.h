@@ -1,19 +1,34 @@
 #pragma once
 
 #include <X11/Xlib.h>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "attribute_.h"
+#include "child.h"
 #include "commandio.h"
 #include "keycombo.h"
 #include "object.h"
+#include "optional.h"
 #include "regexstr.h"
+#include "timerqueue.h"
 #include "xkeygrabber.h"
 
 class Client;
+class CommandBinding;
 class Completion;
 
+/*!
+ * The key modes, each of which has its own key bindings.
+ */
+class KeyModes : public Object {
+public:
+    KeyModes() = default;
+};
+
 /*!
  * Maintains the list of key bindings, and handles the grabbing/ungrabbing with
  * the help of XKeyGrabber
@@ -41,6 +56,7 @@ private:
         KeyMask();
 
         bool allowsBinding(const KeyCombo& combo) const;
+        bool allowsBinding(const std::string& comboString) const;
         std::string str() const { return regex_.str(); }
 
         bool operator==(const KeyMask& other) const {
@@ -60,21 +76,81 @@ private:
     public:
         KeyCombo keyCombo;
         std::vector<std::string> cmd;
+        //! the command cmd[0], resolved when the binding is created
+        const CommandBinding* command = nullptr;
         bool grabbed = false;
     };
 
+    /*!
+     * The key bindings of one key mode (only used internally by KeyManager)
+     */
+    class KeyTable {
+    public:
+        void add(std::unique_ptr<KeyBinding> binding);
+        bool remove(const KeyCombo& combo);
+        void clear();
+        KeyBinding* find(const KeyCombo& combo) const;
+        std::shared_ptr<const std::vector<bool>> allowedBindings(const KeyMask& keyMask,
+                                                                 const KeyMask& keysInactive);
+
+        //! the bindings in the order they were defined
+        std::vector<std::unique_ptr<KeyBinding>> binds;
+        /*! The allowed bindings that the 'grabbed' flags of the bindings
+         * correspond to, or nullptr if this is not known.
+         */
+        std::shared_ptr<const std::vector<bool>> grabbedBindings;
+        //! the number of keymask and keys_inactive pairs that are cached
+        static const size_t allowedBindingsCacheSize_ = 4;
+    private:
+        void bindingsChanged();
+        class AllowedBindings {
+        public:
+            std::string keyMask;
+            std::string keysInactive;
+            //! which of the bindings are allowed, in the order of 'binds'
+            std::shared_ptr<const std::vector<bool>> allowed;
+        };
+        //! The keybindings indexed by their key combination
+        std::unordered_map<KeyCombo, KeyBinding*> bindsByCombo_;
+        /*! The allowed bindings for the most recently used pairs of
+         * keymask and keys_inactive regexes, most recent first.
+         */
+        std::vector<AllowedBindings> allowedBindingsCache_;
+    };
+
 public:
-    KeyManager() = default;
+    /*!
+     * A named key mode with its own key bindings. While a key mode is
+     * active, only its bindings are grabbed instead of the default ones.
+     */
+    class KeyMode : public Object {
+    public:
+        KeyMode(const std::string& name);
+        Attribute_<std::string> name_;
+        Attribute_<bool> sticky_;
+        Attribute_<unsigned long> timeout_;
+        Attribute_<std::string> escape_;
+        std::experimental::optional<KeyCombo> escapeCombo() const;
+    private:
+        friend class KeyManager;
+        std::string validateEscape(std::string escape);
+        KeyTable table_;
+    };
+
+    KeyManager(TimerQueue& timers);
     ~KeyManager();
 
     int addKeybindCommand(Input input, Output output);
-    int listKeybindsCommand(Output output) const;
+    int listKeybindsCommand(Input input, Output output);
     int removeKeybindCommand(Input input, Output output);
+    int keymodeCommand(Input input, Output output);
 
     void addKeybindCompletion(Completion &complete);
+    void listKeybindsCompletion(Completion &complete);
     void removeKeybindCompletion(Completion &complete);
+    void keymodeCompletion(Completion &complete);
 
-    void handleKeyPress(XKeyEvent* ev) const;
+    void handleKeyPress(XKeyEvent* ev);
 
     void regrabAll();
     void ensureKeyMask(const Client* client = nullptr);
@@ -87,11 +163,31 @@ public:
         return xKeyGrabber_.getNumlockMask();
     }
 
-private:
-    bool removeKeyBinding(const KeyCombo& comboToRemove);
+    Attribute_<std::string> mode_;
 
-    //! Currently defined keybindings
-    std::vector<std::unique_ptr<KeyBinding>> binds;
+private:
+    bool parseModeFlag(Input& input, Output output, bool create,
+                       KeyTable*& table, KeyMode*& mode);
+    KeyMode* addKeyMode(const std::string& name);
+    void completeModeFlag(Completion& complete);
+    size_t modeFlagCount(Completion& complete);
+    KeyTable& activeTable();
+    void enterKeyMode(KeyMode* mode);
+    void startKeyModeTimeout();
+    void grabEscape();
+
+    //! The bindings of the default mode
+    KeyTable defaultTable_;
+    //! All other key modes, indexed by their name
+    std::map<std::string, std::unique_ptr<KeyMode>> keyModes_;
+    ChildMember_<KeyModes> modes_;
+    //! The active key mode or nullptr for the default mode
+    KeyMode* activeMode_ = nullptr;
+    TimerQueue& timers_;
+    //! The timer that leaves the active key mode automatically
+    std::experimental::optional<TimerQueue::TimerId> modeTimer_;
+    //! The escape key of the active mode, if it was grabbed
+    std::experimental::optional<KeyCombo> grabbedEscape_;
 
     XKeyGrabber xKeyGrabber_;
 
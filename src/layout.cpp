@@ -39,6 +39,8 @@ Frame::Frame(HSTag* tag, Settings* settings, weak_ptr<FrameSplit> parent)
 {}
 Frame::~Frame() = default;
 
+unsigned long Frame::layoutGeneration_ = 1;
+
 FrameLeaf::FrameLeaf(HSTag* tag, Settings* settings, weak_ptr<FrameSplit> parent)
     : Frame(tag, settings, parent)
     , client_count_(this, "client_count", [this]() {return clientCount(); })
@@ -76,6 +78,7 @@ void FrameLeaf::insertClient(Client* client, bool focus) {
     if (focus) {
         selection = index;
     }
+    invalidateLayout();
     // FRAMETODO: if we we are focused, and were empty before, we have to focus
     // the client now
 }
@@ -109,6 +112,7 @@ bool FrameLeaf::removeClient(Client* client) {
         selection -= (selection < idx) ? 0 : 1;
         // ensure valid index
         selection = std::max(std::min(selection, ((int)clients.size()) - 1), 0);
+        invalidateLayout();
         return true;
     } else {
         return false;
@@ -157,6 +161,7 @@ shared_ptr<FrameSplit> FrameSplit::thisSplit() {
 string FrameSplit::userSetsSplitType(SplitAlign align)
 {
     align_ = align;
+    invalidateLayout();
     relayout();
     return {};
 }
@@ -167,6 +172,7 @@ string FrameSplit::userSetsSelection(int idx)
         return "index out of range";
     }
     selection_ = idx;
+    invalidateLayout();
     relayout();
     return {};
 }
@@ -315,7 +321,40 @@ TilingResult FrameLeaf::layoutGrid(Rectangle rect) {
     return res;
 }
 
-TilingResult FrameLeaf::computeLayout(Rectangle rect) {
+TilingResult Frame::computeLayout(Rectangle rect) {
+    auto cached = cachedLayout(rect);
+    TilingResult res;
+    cached->appendTo(res);
+    res.focus = cached->focus;
+    res.focused_frame = cached->focused_frame;
+    return res;
+}
+
+/*! return the cached layout of this frame, after recomputing it if
+ * necessary. The results of the children are shared and not copied, so
+ * recomputing a frame only costs time in the size of the frame itself.
+ */
+shared_ptr<const TilingResult> Frame::cachedLayout(Rectangle rect) {
+    if (!cachedLayout_ || layoutDirty_ || rect != cachedRect_
+        || cachedGeneration_ != layoutGeneration_)
+    {
+        cachedLayout_ = make_shared<const TilingResult>(computeLayoutUncached(rect));
+        cachedRect_ = rect;
+        cachedGeneration_ = layoutGeneration_;
+        layoutDirty_ = false;
+    }
+    return cachedLayout_;
+}
+
+void Frame::invalidateLayout() {
+    layoutDirty_ = true;
+    auto parent = parent_.lock();
+    if (parent) {
+        parent->invalidateLayout();
+    }
+}
+
+TilingResult FrameLeaf::computeLayoutUncached(Rectangle rect) {
     last_rect = rect;
     if (!settings_->smart_frame_surroundings() || parent_.lock()) {
         // apply frame gap
@@ -402,7 +441,7 @@ TilingResult FrameLeaf::computeLayout(Rectangle rect) {
     return res;
 }
 
-TilingResult FrameSplit::computeLayout(Rectangle rect) {
+TilingResult FrameSplit::computeLayoutUncached(Rectangle rect) {
     last_rect = rect;
     auto first = rect;
     auto second = rect;
@@ -416,12 +455,11 @@ TilingResult FrameSplit::computeLayout(Rectangle rect) {
         second.width -= first.width;
     }
     TilingResult res;
-    auto res1 = a_->computeLayout(first);
-    auto res2 = b_->computeLayout(second);
-    res.mergeFrom(res1);
-    res.mergeFrom(res2);
-    res.focus = (selection_ == 0) ? res1.focus : res2.focus;
-    res.focused_frame = (selection_ == 0) ? res1.focused_frame : res2.focused_frame;
+    auto res1 = a_->cachedLayout(first);
+    auto res2 = b_->cachedLayout(second);
+    res.focus = (selection_ == 0) ? res1->focus : res2->focus;
+    res.focused_frame = (selection_ == 0) ? res1->focused_frame : res2->focused_frame;
+    res.children = { res1, res2 };
     return res;
 }
 
@@ -463,6 +501,7 @@ void FrameLeaf::setSelection(int index) {
         index = clients.size() - 1;
     }
     selection = index;
+    invalidateLayout();
 }
 
 int Frame::splitsToRoot(SplitAlign align) {
@@ -498,6 +537,7 @@ bool FrameSplit::split(SplitAlign alignment, FixPrecDec fraction)
     tag_->frame->replaceNode(shared_from_this(), new_this);
     first->parent_ = new_this;
     second->parent_ = new_this;
+    invalidateLayout();
     return true;
 }
 
@@ -512,11 +552,13 @@ void FrameSplit::replaceChild(shared_ptr<Frame> old, shared_ptr<Frame> newchild)
         newchild->parent_ = thisSplit();
         bLink_ = b_.get();
     }
+    newchild->invalidateLayout();
 }
 
 void FrameLeaf::addClients(const vector<Client*>& vec, bool atFront) {
     auto targetPosition = atFront ? clients.begin() : clients.end();
     clients.insert(targetPosition, vec.begin(), vec.end());
+    invalidateLayout();
 }
 
 bool FrameLeaf::split(SplitAlign alignment, FixPrecDec fraction, size_t childrenLeaving) {
@@ -543,6 +585,7 @@ bool FrameLeaf::split(SplitAlign alignment, FixPrecDec fraction, size_t children
         second->setSelection(selection - childrenStaying);
         selection = std::max(0, childrenStaying - 1);
     }
+    invalidateLayout();
     return true;
 }
 
@@ -551,16 +594,19 @@ void FrameSplit::swapChildren() {
     swap(a_,b_);
     aLink_ = a_.get();
     bLink_ = b_.get();
+    invalidateLayout();
 }
 
 void FrameSplit::adjustFraction(FixPrecDec delta) {
     fraction_ = fraction_ + delta;
     fraction_ = clampFraction(fraction_);
+    invalidateLayout();
 }
 
 void FrameSplit::setFraction(FixPrecDec fraction)
 {
     fraction_ = clampFraction(fraction);
+    invalidateLayout();
 }
 
 FixPrecDec FrameSplit::clampFraction(FixPrecDec fraction)
@@ -723,12 +769,14 @@ string FrameLeaf::userSetsSelection(int index)
 void FrameLeaf::moveClient(int new_index) {
     swap(clients[new_index], clients[selection]);
     selection = new_index;
+    invalidateLayout();
 }
 
 void FrameLeaf::select(Client* client) {
     auto it = find(clients.begin(), clients.end(), client);
     if (it != clients.end()) {
         selection = it - clients.begin();
+        invalidateLayout();
     }
 }
 
@@ -815,5 +863,6 @@ vector<Client*> FrameLeaf::removeAllClients() {
     vector<Client*> result;
     swap(result, clients);
     selection = 0;
+    invalidateLayout();
     return result;
 }
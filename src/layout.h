@@ -34,7 +34,16 @@ public:
     virtual bool removeClient(Client* client) = 0;
 
     virtual bool isFocused();
-    virtual TilingResult computeLayout(Rectangle rect) = 0;
+    /*! compute the layout of this frame and its children. The layout of
+     * each frame is cached, and only recomputed if the frame or one of its
+     * children was modified (see invalidateLayout()) or if the rectangle
+     * differs. The returned result is a flat copy of the cached results.
+     */
+    TilingResult computeLayout(Rectangle rect);
+    //! mark the cached layout of this frame and of its ancestors outdated
+    void invalidateLayout();
+    //! mark the cached layouts of all frames outdated, e.g. if a setting changes
+    static void invalidateAllLayouts() { layoutGeneration_++; }
     virtual Client* focusedClient() = 0;
 
     // do recursive for each element of the (binary) frame tree
@@ -85,11 +94,19 @@ public: // soon will be protected:
     virtual std::shared_ptr<FrameLeaf> isLeaf() { return std::shared_ptr<FrameLeaf>(); };
 protected:
     void relayout();
+    virtual TilingResult computeLayoutUncached(Rectangle rect) = 0;
     HSTag* tag_;
     Settings* settings_;
     std::weak_ptr<FrameSplit> parent_;
     Rectangle  last_rect; // last rectangle when being drawn
                           // this is only used for 'split explode'
+private:
+    std::shared_ptr<const TilingResult> cachedLayout(Rectangle rect);
+    bool layoutDirty_ = true;
+    Rectangle cachedRect_;
+    unsigned long cachedGeneration_ = 0;
+    std::shared_ptr<const TilingResult> cachedLayout_;
+    static unsigned long layoutGeneration_;
 };
 
 class FrameLeaf : public Frame, public FrameDataLeaf {
@@ -103,8 +120,6 @@ public:
     bool removeClient(Client* client) override;
     void moveClient(int new_index);
 
-    TilingResult computeLayout(Rectangle rect) override;
-
     virtual void fmap(std::function<void(FrameSplit*)> onSplit,
                       std::function<void(FrameLeaf*)> onLeaf, int order) override;
 
@@ -119,7 +134,7 @@ public:
 
     bool split(SplitAlign alignment, FixPrecDec fraction, size_t childrenLeaving = 0);
     LayoutAlgorithm getLayout() { return layout; }
-    void setLayout(LayoutAlgorithm l) { layout = l; }
+    void setLayout(LayoutAlgorithm l) { layout = l; invalidateLayout(); }
     int getSelection() { return selection; }
     size_t clientCount() { return clients.size(); }
     std::shared_ptr<Frame> neighbour(Direction direction);
@@ -134,6 +149,8 @@ public:
     DynAttribute_<int> client_count_;
     DynAttribute_<int> selectionAttr_;
     DynAttribute_<LayoutAlgorithm> algorithmAttr_;
+protected:
+    TilingResult computeLayoutUncached(Rectangle rect) override;
 private:
     std::string userSetsLayout(LayoutAlgorithm algo);
     std::string userSetsSelection(int index);
@@ -159,8 +176,6 @@ public:
     std::shared_ptr<FrameLeaf> frameWithClient(Client* client) override;
     bool removeClient(Client* client) override;
 
-    TilingResult computeLayout(Rectangle rect) override;
-
     virtual void fmap(std::function<void(FrameSplit*)> onSplit,
                       std::function<void(FrameLeaf*)> onLeaf, int order) override;
 
@@ -181,14 +196,16 @@ public:
     std::shared_ptr<FrameSplit> thisSplit();
     std::shared_ptr<FrameSplit> isSplit() override { return thisSplit(); }
     SplitAlign getAlign() { return align_; }
-    void swapSelection() { selection_ = selection_ == 0 ? 1 : 0; }
-    void setSelection(int s) { selection_ = s; }
+    void swapSelection() { selection_ = selection_ == 0 ? 1 : 0; invalidateLayout(); }
+    void setSelection(int s) { selection_ = s; invalidateLayout(); }
     int getSelection() { return selection_; }
     DynAttribute_<SplitAlign> splitTypeAttr_;
     DynAttribute_<FixPrecDec> fractionAttr_;
     DynAttribute_<int> selectionAttr_;
     Link_<Frame> aLink_;
     Link_<Frame> bLink_;
+protected:
+    TilingResult computeLayoutUncached(Rectangle rect) override;
 private:
     std::string userSetsSplitType(SplitAlign align);
     std::string userSetsFraction(FixPrecDec fraction);
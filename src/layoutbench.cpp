@@ -0,0 +1,130 @@
+/** A micro-benchmark of the layout computation of a frame tree in which
+ * only one frame was modified, as it is the case after most commands. It
+ * distributes 512 clients over balanced frame trees of increasing depth,
+ * changes the layout algorithm of the focused leaf, and measures
+ * Frame::computeLayout() of the root. For comparison, it also measures
+ * the layout from scratch. Clients can only be created on an X display,
+ * so run it on a spare X server, e.g.:
+ *
+ *     Xvfb :9 & DISPLAY=:9 ./layoutbench
+ *
+ * Build it with 'make layoutbench' in the build directory.
+ */
+
+#include <X11/Xlib.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "client.h"
+#include "clientmanager.h"
+#include "ewmh.h"
+#include "fontdata.h"
+#include "frametree.h"
+#include "ipc-server.h"
+#include "layout.h"
+#include "monitor.h"
+#include "monitormanager.h"
+#include "root.h"
+#include "tag.h"
+#include "xconnection.h"
+
+using std::string;
+using std::vector;
+
+// these are defined in main.cpp, which is not linked into the benchmark
+int g_verbose = 0;
+Display* g_display = nullptr;
+Window g_root = 0;
+
+//! a balanced frame tree of the given depth with the given clients per leaf
+static string treeLayout(int depth, size_t clientsPerLeaf,
+                         vector<Window>::const_iterator& window) {
+    if (depth == 0) {
+        string layout = "(clients vertical:0";
+        for (size_t i = 0; i < clientsPerLeaf; i++) {
+            layout += " " + WindowID(*window).str();
+            window++;
+        }
+        return layout + ")";
+    }
+    string align = (depth % 2) ? "horizontal" : "vertical";
+    string first = treeLayout(depth - 1, clientsPerLeaf, window);
+    string second = treeLayout(depth - 1, clientsPerLeaf, window);
+    return "(split " + align + ":0.5:0 " + first + " " + second + ")";
+}
+
+static double nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+int main(int argc, char** argv) {
+    XConnection* X = XConnection::connect();
+    g_display = X->display();
+    if (!g_display) {
+        fprintf(stderr, "layoutbench: cannot open display\n");
+        delete X;
+        return 1;
+    }
+    g_root = X->root();
+    Ewmh* ewmh = new Ewmh(*X);
+    ewmh->installWmWindow();
+    FontData::s_xconnection = X;
+    IpcServer* ipcServer = new IpcServer(*X);
+    auto root = std::make_shared<Root>(Globals(), *X, *ewmh, *ipcServer);
+    Root::setRoot(root);
+    root->monitors()->ensure_monitors_are_available();
+    Monitor* monitor = root->monitors()->focus();
+    HSTag* tag = monitor->tag;
+
+    const int maxDepth = 8;
+    vector<Window> windows;
+    for (int i = 0; i < (2 << maxDepth); i++) {
+        Window win = XCreateSimpleWindow(X->display(), X->root(), 0, 0, 100, 100, 0, 0, 0);
+        if (root->clients()->manage_client(win, false, false)) {
+            windows.push_back(win);
+        }
+    }
+
+    const int repetitions = 2000;
+    for (int depth = 2; depth <= maxDepth; depth += 2) {
+        auto window = windows.cbegin();
+        size_t clientsPerLeaf = windows.size() >> depth;
+        string layout = treeLayout(depth, clientsPerLeaf, window);
+        std::ostringstream output;
+        tag->frame->loadCommand(Input("load", {layout}), output);
+        auto rootFrame = tag->frame->root_;
+        auto leaf = tag->frame->focusedFrame();
+        size_t tiled = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            leaf->setLayout((i % 2) ? LayoutAlgorithm::vertical
+                                    : LayoutAlgorithm::horizontal);
+            tiled += rootFrame->computeLayout(monitor->rect).data.size();
+        }
+        double modified = nanosecondsSince(start) / repetitions;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            Frame::invalidateAllLayouts();
+            tiled += rootFrame->computeLayout(monitor->rect).data.size();
+        }
+        double scratch = nanosecondsSince(start) / repetitions;
+        printf("depth %d, %3zu clients per frame: %9.0f ns after modifying "
+               "one frame, %9.0f ns from scratch   (%zu clients)\n",
+               depth, clientsPerLeaf, modified, scratch,
+               tiled / (2 * repetitions));
+    }
+
+    root->shutdown();
+    root.reset();
+    Root::setRoot(root);
+    FontData::s_xconnection = nullptr;
+    delete ipcServer;
+    delete ewmh;
+    delete X;
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <vector>
 
+#include "attributejournal.h"
 #include "client.h"
 #include "clientmanager.h"
 #include "command.h"
@@ -77,8 +78,15 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
     Settings* settings = root->settings();
     TagManager* tags = root->tags();
     Tmp* tmp = root->tmp();
+    AttributeJournal* journal = root->journal();
     Watchers* watchers = root->watchers();
 
+    // commands that read the window geometries or the focused client,
+    // including all commands that resolve attribute paths (clients.focus)
+    auto readsLayout = [](CommandBinding binding) {
+        return binding.readsLayout();
+    };
+
     std::initializer_list<pair<const string,CommandBinding>> init =
     {
         {"quit",           { quit } },
@@ -97,12 +105,15 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
         {"set_monitors",   {monitors, &MonitorManager::setMonitorsCommand,
                                       &MonitorManager::setMonitorsCompletion} },
         {"disjoin_rects",  disjoin_rects_command},
-        {"list_keybinds",  {keys, &KeyManager::listKeybindsCommand }},
+        {"list_keybinds",  {keys, &KeyManager::listKeybindsCommand,
+                                  &KeyManager::listKeybindsCompletion}},
         {"list_padding",   monitors->byFirstArg(&Monitor::list_padding, &Monitor::noComplete) },
         {"keybind",        {keys, &KeyManager::addKeybindCommand,
                                   &KeyManager::addKeybindCompletion}},
         {"keyunbind",      {keys, &KeyManager::removeKeybindCommand,
                                   &KeyManager::removeKeybindCompletion}},
+        {"keymode",        {keys, &KeyManager::keymodeCommand,
+                                  &KeyManager::keymodeCompletion}},
         {"mousebind",      {mouse, &MouseManager::addMouseBindCommand,
                                    &MouseManager::addMouseBindCompletion}},
         {"mouseunbind",    {mouse, &MouseManager::mouse_unbind_all }},
@@ -117,7 +128,7 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
         {"cycle_all",      monitors->tagCommand(&HSTag::cycleAllCommand)},
         {"cycle_layout",   tags->frameCommand(&FrameTree::cycleLayoutCommand, &FrameTree::cycleLayoutCompletion) },
         {"cycle_frame",    { tags->frameCommand(&FrameTree::cycleFrameCommand) }},
-        {"close",          { global_cmds, &GlobalCommands::closeCommand }},
+        {"close",          readsLayout({ global_cmds, &GlobalCommands::closeCommand })},
         {"close_or_remove",{ monitors->tagCommand(&HSTag::closeOrRemoveCommand) }},
         {"close_and_remove",{ monitors->tagCommand(&HSTag::closeAndRemoveCommand) }},
         {"split",          { tags->frameCommand(&FrameTree::splitCommand) }},
@@ -137,8 +148,8 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                        &Settings::get_complete }},
         {"toggle",         { settings, &Settings::toggle_cmd,
                                        &Settings::toggle_complete}},
-        {"cycle_value",    { global_cmds, &GlobalCommands::cycleValueCommand,
-                                          &GlobalCommands::cycleValueCompletion}},
+        {"cycle_value",    readsLayout({ global_cmds, &GlobalCommands::cycleValueCommand,
+                                                      &GlobalCommands::cycleValueCompletion}) },
         {"cycle_monitor",  { monitors, &MonitorManager::cycleCommand }},
         {"focus_monitor",  { monitors, &MonitorManager::focusCommand }},
         {"add",            { tags, &TagManager::addCommand }},
@@ -180,7 +191,7 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                      &ClientManager::applyTmpRuleCompletion}},
         {"list_rules",     {rules, &RuleManager::listRulesCommand }},
         {"layout",         tags->frameCommand(&FrameTree::dumpLayoutCommand, &FrameTree::dumpLayoutCompletion)},
-        {"stack",          { monitors, &MonitorManager::stackCommand }},
+        {"stack",          readsLayout({ monitors, &MonitorManager::stackCommand })},
         {"dump",           tags->frameCommand(&FrameTree::dumpLayoutCommand, &FrameTree::dumpLayoutCompletion)},
         {"load",           { tags->frameCommand(&FrameTree::loadCommand, &FrameTree::loadCompletion ) }},
         {"complete",       completeCommand},
@@ -200,20 +211,20 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                             &MetaCommands::chainCompletion}},
         {"or",             { meta_commands, &MetaCommands::chainCommand,
                                             &MetaCommands::chainCompletion}},
-        {"object_tree",    { meta_commands, &MetaCommands::print_object_tree_command,
-                                            &MetaCommands::print_object_tree_complete} },
-        {"substitute",     { meta_commands, &MetaCommands::substitute_cmd,
-                                            &MetaCommands::substitute_complete} },
-        {"foreach",        { meta_commands, &MetaCommands::foreachCmd,
-                                            &MetaCommands::foreachComplete} },
-        {"sprintf",        { meta_commands, &MetaCommands::sprintf_cmd,
-                                            &MetaCommands::sprintf_complete} },
-        {"new_attr",       { meta_commands, &MetaCommands::new_attr_cmd,
-                                            &MetaCommands::new_attr_complete} },
-        {"remove_attr",    { meta_commands, &MetaCommands::remove_attr_cmd,
-                                            &MetaCommands::remove_attr_complete }},
-        {"compare",        { meta_commands, &MetaCommands::compare_cmd,
-                                            &MetaCommands::compare_complete} },
+        {"object_tree",    readsLayout({ meta_commands, &MetaCommands::print_object_tree_command,
+                                                        &MetaCommands::print_object_tree_complete}) },
+        {"substitute",     readsLayout({ meta_commands, &MetaCommands::substitute_cmd,
+                                                        &MetaCommands::substitute_complete}) },
+        {"foreach",        readsLayout({ meta_commands, &MetaCommands::foreachCmd,
+                                                        &MetaCommands::foreachComplete}) },
+        {"sprintf",        readsLayout({ meta_commands, &MetaCommands::sprintf_cmd,
+                                                        &MetaCommands::sprintf_complete}) },
+        {"new_attr",       readsLayout({ meta_commands, &MetaCommands::new_attr_cmd,
+                                                        &MetaCommands::new_attr_complete}) },
+        {"remove_attr",    readsLayout({ meta_commands, &MetaCommands::remove_attr_cmd,
+                                                        &MetaCommands::remove_attr_complete })},
+        {"compare",        readsLayout({ meta_commands, &MetaCommands::compare_cmd,
+                                                        &MetaCommands::compare_complete}) },
         {"getenv",         { meta_commands, &MetaCommands::getenvCommand,
                                             &MetaCommands::getenvUnsetenvCompletion}},
         {"setenv",         { meta_commands, &MetaCommands::setenvCommand,
@@ -222,18 +233,22 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                             &MetaCommands::exportEnvCompletion}},
         {"unsetenv",       { meta_commands, &MetaCommands::unsetenvCommand,
                                             &MetaCommands::getenvUnsetenvCompletion}},
-        {"get_attr",       { meta_commands, &MetaCommands::get_attr_cmd,
-                                            &MetaCommands::get_attr_complete }},
-        {"set_attr",       { meta_commands, &MetaCommands::set_attr_cmd,
-                                            &MetaCommands::set_attr_complete }},
-        {"attr_type",      { meta_commands, &MetaCommands::attrTypeCommand,
-                                            &MetaCommands::attrTypeCompletion }},
-        {"help",           { meta_commands, &MetaCommands::helpCommand,
-                                            &MetaCommands::helpCompletion }},
-        {"attr",           { meta_commands, &MetaCommands::attr_cmd,
-                                            &MetaCommands::attr_complete }},
-        {"watch",          { watchers, &Watchers::watchCommand,
-                                       &Watchers::watchCompletion }},
+        {"get_attr",       readsLayout({ meta_commands, &MetaCommands::get_attr_cmd,
+                                                        &MetaCommands::get_attr_complete })},
+        {"set_attr",       readsLayout({ meta_commands, &MetaCommands::set_attr_cmd,
+                                                        &MetaCommands::set_attr_complete })},
+        {"attr_type",      readsLayout({ meta_commands, &MetaCommands::attrTypeCommand,
+                                                        &MetaCommands::attrTypeCompletion })},
+        {"dump_attr",      readsLayout({ meta_commands, &MetaCommands::dumpAttrCommand,
+                                                        &MetaCommands::dumpAttrCompletion })},
+        {"help",           readsLayout({ meta_commands, &MetaCommands::helpCommand,
+                                                        &MetaCommands::helpCompletion })},
+        {"attr",           readsLayout({ meta_commands, &MetaCommands::attr_cmd,
+                                                        &MetaCommands::attr_complete })},
+        {"attr_changes",   readsLayout({ journal, &AttributeJournal::changesCommand,
+                                                  &AttributeJournal::changesCompletion })},
+        {"watch",          readsLayout({ watchers, &Watchers::watchCommand,
+                                                   &Watchers::watchCompletion })},
         {"mktemp",         { tmp, &Tmp::mktemp,
                                   &Tmp::mktempComplete }},
     };
@@ -15,6 +15,7 @@
 #include "completion.h"
 #include "finite.h"
 #include "ipc-protocol.h"
+#include "utils.h"
 
 using std::endl;
 using std::function;
@@ -105,7 +106,25 @@ int MetaCommands::attr_cmd(Input in, Output output) {
     }
 }
 
+Attribute* MetaCommands::cachedAttribute(const string& path) {
+    // the number of compiled paths to remember
+    const size_t maxPaths = 1000;
+    auto it = attributePaths_.find(path);
+    if (it == attributePaths_.end()) {
+        if (attributePaths_.size() >= maxPaths) {
+            attributePaths_.clear();
+        }
+        it = attributePaths_.emplace(path, AttributePath(path)).first;
+    }
+    return it->second.resolve(root);
+}
+
 Attribute* MetaCommands::getAttribute(string path, Output output) {
+    Attribute* cached = cachedAttribute(path);
+    if (cached) {
+        return cached;
+    }
+    // look up the path again for the error message
     auto attr_path = Object::splitPath(path);
     auto child = root.child(attr_path.first);
     if (!child) {
@@ -183,6 +202,60 @@ void MetaCommands::attrTypeCompletion(Completion& complete)
 }
 
 
+int MetaCommands::dumpAttrCommand(Input input, Output output)
+{
+    string pathString = "";
+    ArgParse ap = ArgParse().optional(pathString);
+    if (ap.parsingAllFails(input, output)) {
+        return ap.exitCode();
+    }
+    // remove trailing dots, as in foreach
+    while (!pathString.empty() && pathString.back() == OBJECT_PATH_SEPARATOR) {
+        pathString.erase(pathString.size() - 1);
+    }
+    Path path { pathString, OBJECT_PATH_SEPARATOR };
+    Object* object = root.child(path, output);
+    if (!object) {
+        return HERBST_INVALID_ARGUMENT;
+    }
+    if (!pathString.empty()) {
+        pathString += OBJECT_PATH_SEPARATOR;
+    }
+    dumpAttributes(*object, pathString, output);
+    return 0;
+}
+
+void MetaCommands::dumpAttrCompletion(Completion& complete)
+{
+    if (complete == 0) {
+        completeObjectPath(complete);
+    } else {
+        complete.none();
+    }
+}
+
+/** print one line per attribute of the given object and (recursively) of
+ * its children, in the form PATH<tab>TYPE<tab>FLAGS<tab>VALUE. In the value,
+ * backslashes, tabs and newlines are escaped as \\, \t and \n such that
+ * every attribute occupies exactly one line.
+ */
+void MetaCommands::dumpAttributes(Object& object, const string& path, Output output)
+{
+    for (const auto& it : object.attributes()) {
+        Attribute* a = it.second;
+        output << path << it.first
+               << '\t' << a->typechar()
+               << '\t' << (a->writable() ? 'w' : '-') << (a->hookable() ? 'h' : '-')
+               << '\t' << tab_field_escape(a->str())
+               << '\n';
+    }
+    object.forEachChild([&](const string& name, Object* child) {
+        if (child) {
+            dumpAttributes(*child, path + name + OBJECT_PATH_SEPARATOR, output);
+        }
+    });
+}
+
 int MetaCommands::substitute_cmd(Input input, Output output)
 {
     string ident, path;
@@ -237,9 +310,9 @@ int MetaCommands::foreachCmd(Input input, Output output)
     if (!pathString.empty()) {
         pathString += OBJECT_PATH_SEPARATOR;
     }
-    for (const auto& entry : object->children()) {
-        childPaths.push_back(pathString + entry.first);
-    }
+    object->forEachChild([&](const string& name, Object*) {
+        childPaths.push_back(pathString + name);
+    });
     int  lastStatusCode = 0;
     for (const auto& child : childPaths) {
         Input carryover = input.fromHere();
@@ -575,7 +648,11 @@ int MetaCommands::compare_cmd(Input input, Output output)
     if (ap.parsingFails(input, output)) {
         return ap.exitCode();
     }
-    Attribute* a = root.deepAttribute(path, output);
+    Attribute* a = cachedAttribute(path);
+    if (!a) {
+        // look up the path again for the error message
+        a = root.deepAttribute(path, output);
+    }
     if (!a) {
         return HERBST_INVALID_ARGUMENT;
     }
@@ -650,9 +727,9 @@ void MetaCommands::completeObjectPath(Completion& complete, Object* rootObject,
             complete.full(objectPath + it.first);
         }
     }
-    for (auto& it : object->children()) {
-        complete.partial(objectPath + it.first + OBJECT_PATH_SEPARATOR);
-    }
+    object->forEachChild([&](const string& name, Object*) {
+        complete.partial(objectPath + name + OBJECT_PATH_SEPARATOR);
+    });
 }
 
 void MetaCommands::completeObjectPath(Completion& complete, bool attributes,
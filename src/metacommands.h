@@ -3,9 +3,11 @@
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "attribute.h"
+#include "attributepath.h"
 #include "commandio.h"
 #include "converter.h"
 
@@ -29,6 +31,8 @@ public:
     MetaCommands(Object& root);
 
     Attribute* getAttribute(std::string path, Output output);
+    //! like getAttribute() but without error messages
+    Attribute* cachedAttribute(const std::string& path);
 
     /* external interface */
     // find an attribute deep in the object tree.
@@ -44,6 +48,8 @@ public:
     void print_object_tree_complete(Completion& complete);
     int attrTypeCommand(Input input, Output output);
     void attrTypeCompletion(Completion& complete);
+    int dumpAttrCommand(Input input, Output output);
+    void dumpAttrCompletion(Completion& complete);
 
     int substitute_cmd(Input input, Output output);
     void substitute_complete(Completion& complete);
@@ -92,6 +98,8 @@ public:
 private:
     Object& root;
     std::vector<std::unique_ptr<Attribute>> userAttributes_;
+    //! the paths that have been read recently, e.g. by scripts
+    std::unordered_map<std::string, AttributePath> attributePaths_;
 
     class FormatStringBlob {
     public:
@@ -100,6 +108,7 @@ private:
     };
     typedef std::vector<FormatStringBlob> FormatString;
     FormatString parseFormatString(const std::string& format);
+    void dumpAttributes(Object& object, const std::string& path, Output output);
 };
 
 
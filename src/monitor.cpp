@@ -46,7 +46,6 @@ Monitor::Monitor(Settings* settings_, MonitorManager* monman_, Rectangle rect_,
     , lock_tag  (this, "lock_tag", false)
     , pad_automatically_set ({false, false, false, false})
     , dirty(true)
-    , lock_frames(false)
     , mouse { 0, 0 }
     , rect(this, "geometry", rect_, &Monitor::atLeastMinWindowSize)
     , settings(settings_)
@@ -149,11 +148,18 @@ bool Monitor::setTag(HSTag* new_tag) {
     return owner == this;
 }
 
+/** Mark the monitor for a relayout. The actual layouting happens in
+ * MonitorManager::applyDirtyLayouts() once a command needs the new layout,
+ * after the current command or after the current batch of X events, so
+ * calling this multiple times within one command or one batch of X events
+ * is cheap.
+ */
 void Monitor::applyLayout() {
-    if (settings->monitors_locked) {
-        dirty = true;
-        return;
-    }
+    dirty = true;
+}
+
+//! arrange the clients and frames of this monitor immediately
+void Monitor::applyLayoutNow() {
     dirty = false;
     Rectangle cur_rect = rect;
     // apply pad
@@ -435,9 +441,8 @@ int monitor_set_tag(Monitor* monitor, HSTag* tag) {
     monitor->tag = tag;
     // first reset focus and arrange windows
     monitor->restack();
-    monitor->lock_frames = true;
     monitor->applyLayout();
-    monitor->lock_frames = false;
+    g_monitors->applyDirtyLayout(monitor);
     // then show them (should reduce flicker)
     tag->setVisible(true);
     if (!monitor->tag->floating) {
@@ -33,8 +33,7 @@ public:
     // whether the above pads were determined automatically
     // from autodetected panels
     std::vector<bool>       pad_automatically_set;
-    bool        dirty;
-    bool        lock_frames;
+    bool        dirty; // whether a relayout is pending
     struct {
         // last saved mouse position
         int x;
@@ -54,6 +53,7 @@ public:
     void renameComplete(Completion& complete);
     bool setTag(HSTag* new_tag);
     void applyLayout();
+    void applyLayoutNow();
     void restack();
     std::string getDescription();
     void evaluateClientPlacement(Client* client, ClientPlacement placement) const;
@@ -486,15 +486,25 @@ void MonitorManager::unlock() {
     }
 }
 
-void MonitorManager::lock_number_changed() {
-    if (!settings_->monitors_locked()) {
-        // if not locked anymore, then repaint all the dirty monitors
-        for (auto m : *this) {
-            if (m->dirty) {
-                m->applyLayout();
-            }
-        }
+/** Relayout every monitor that was marked dirty by Monitor::applyLayout()
+ * since the last call. This is called by the main loop once it has
+ * processed all pending X events, after every command, and before a
+ * command that reads the window geometries or the focus. While the
+ * monitors are locked, nothing is done.
+ */
+void MonitorManager::applyDirtyLayouts() {
+    for (Monitor* m : *this) {
+        applyDirtyLayout(m);
+    }
+}
+
+//! relayout the given monitor if it is dirty and the monitors are not locked
+void MonitorManager::applyDirtyLayout(Monitor* monitor) {
+    if (settings_->monitors_locked() || !monitor->dirty) {
+        return;
     }
+    relayouts_++;
+    monitor->applyLayoutNow();
 }
 
 //! return the stack of windows by successive calls to the given yield
@@ -77,7 +77,9 @@ public:
 
     void lock();
     void unlock();
-    void lock_number_changed();
+    void applyDirtyLayouts();
+    void applyDirtyLayout(Monitor* monitor);
+    unsigned long relayouts() const { return relayouts_; }
 
     int stackCommand(Output output);
     void extractWindowStack(bool real_clients, std::function<void(Window)> yield);
@@ -120,6 +122,8 @@ private:
     PanelManager* panels_;
     TagManager* tags_;
     Settings* settings_;
+    //! the number of monitor relayouts so far
+    unsigned long relayouts_ = 0;
 };
 
 #endif
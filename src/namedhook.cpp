@@ -145,11 +145,11 @@ void NamedHook::complete_chain() {
 
     // process everything until leaf (note: path_ does not include root)
     for (auto i = chain_.size() - 1; i < path_.size(); ++i) {
-        auto next = current->children().find(path_[i]);
-        if (next != current->children().end()) {
-            next->second->addHook(this);
-            chain_.emplace_back(next->second);
-            current = next->second;
+        Object* next = current->child(path_[i]);
+        if (next) {
+            next->addHook(this);
+            chain_.emplace_back(next);
+            current = next;
         }
     }
 
@@ -19,6 +19,8 @@ using std::shared_ptr;
 using std::string;
 using std::vector;
 
+unsigned long Object::structureGeneration_ = 1;
+
 ChildEntry::ChildEntry(Object& owner, const string& name)
     : owner_(owner)
     , name_(name)
@@ -36,8 +38,19 @@ pair<ArgList,string> Object::splitPath(const string &path) {
     return make_pair(splitpath, last);
 }
 
+Object::~Object()
+{
+    structureGeneration_++;
+    // a hook might remove itself from hooks_ when being notified
+    auto hooks = hooks_;
+    for (auto h : hooks) {
+        h->objectDestroyed(this);
+    }
+}
+
 void Object::wireAttributes(vector<Attribute*> attrs)
 {
+    structureGeneration_++;
     for (auto attr : attrs) {
         attr->setOwner(this);
         attribs_[attr->name()] = attr;
@@ -45,8 +58,10 @@ void Object::wireAttributes(vector<Attribute*> attrs)
 }
 
 void Object::addAttribute(Attribute* attr) {
+    structureGeneration_++;
     attr->setOwner(this);
     attribs_[attr->name()] = attr;
+    notifyHooks(HookEvent::ATTRIBUTE_CHANGED, attr->name());
 }
 
 void Object::removeAttribute(Attribute* attr) {
@@ -58,6 +73,8 @@ void Object::removeAttribute(Attribute* attr) {
         return;
     }
     attribs_.erase(it);
+    structureGeneration_++;
+    notifyHooks(HookEvent::ATTRIBUTE_CHANGED, attr->name());
 }
 
 void Object::ls(Output out)
@@ -71,12 +88,12 @@ void Object::ls(Output out)
             out << "\n";
         }
     }
-    const auto& children = this->children();
-    out << children.size() << (children.size() == 1 ? " child" : " children")
-        << (!children.empty() ? ":" : ".") << endl;
-    for (auto it : children) {
-        out << "  " << it.first << "." << endl;
-    }
+    size_t childCount = this->childCount();
+    out << childCount << (childCount == 1 ? " child" : " children")
+        << (childCount > 0 ? ":" : ".") << endl;
+    forEachChild([&out](const string& name, Object*) {
+        out << "  " << name << "." << endl;
+    });
 
     out << attribs_.size() << (attribs_.size() == 1 ? " attribute" : " attributes")
         << (!attribs_.empty() ? ":" : ".") << endl;
@@ -168,11 +185,13 @@ void Object::notifyHooks(HookEvent event, const string& arg)
 
 void Object::addDynamicChild(function<Object* ()> child, const string& name)
 {
+    structureGeneration_++;
     childrenDynamic_[name] = child;
 }
 
 void Object::addChild(Object* child, const string &name)
 {
+    structureGeneration_++;
     children_[name] = child;
     notifyHooks(HookEvent::CHILD_ADDED, name);
 }
@@ -181,6 +200,7 @@ void Object::removeChild(const string &child)
 {
     notifyHooks(HookEvent::CHILD_REMOVED, child);
     children_.erase(child);
+    structureGeneration_++;
 }
 
 void Object::addChildDoc(const string& name, HasDocumentation* doc)
@@ -219,24 +239,27 @@ void Object::removeHook(Hook* hook)
 }
 
 std::map<string, Object*> Object::children() {
-    // copy the map of 'static' children
-    auto allChildren = children_;
-    // and add the dynamic children
-    for (auto& it : childrenDynamic_) {
-        Object* obj = it.second();
-        if (obj) {
-            allChildren[it.first] = obj;
-        }
-    }
+    std::map<string, Object*> allChildren;
+    forEachChild([&allChildren](const string& name, Object* child) {
+        allChildren.emplace_hint(allChildren.end(), name, child);
+    });
     return allChildren;
 }
 
+size_t Object::childCount() {
+    size_t count = 0;
+    forEachChild([&count](const string&, Object*) {
+        count++;
+    });
+    return count;
+}
+
 class DirectoryTreeInterface : public TreeInterface {
 public:
     DirectoryTreeInterface(string label, Object* d) : lbl(label), dir(d) {
-        for (auto child : dir->children()) {
-            buf.push_back(child);
-        }
+        dir->forEachChild([this](const string& name, Object* child) {
+            buf.push_back(make_pair(name, child));
+        });
     };
     size_t childCount() override {
         return buf.size();
@@ -44,7 +44,7 @@ class Object : public HasDocumentation {
 
 public:
     Object() = default;
-    virtual ~Object() = default;
+    virtual ~Object();
 
     // object tree ls command
     virtual void ls(Output out);
@@ -60,7 +60,7 @@ public:
 
     void addAttribute(Attribute* a);
     void removeAttribute(Attribute* a);
-    std::map<std::string, Attribute*> attributes() { return attribs_; }
+    const std::map<std::string, Attribute*>& attributes() { return attribs_; }
 
     // if a concrete object maintains its index within the parent as an
     // attribute (e.g. monitors and tags do), then they should implement the
@@ -68,6 +68,10 @@ public:
     virtual void setIndexAttribute(unsigned long index) { };
 
     Object* child(const std::string &name);
+    //! whether the child with the given name is a dynamic child
+    bool hasDynamicChild(const std::string &name) const {
+        return childrenDynamic_.find(name) != childrenDynamic_.end();
+    }
 
     Object* child(Path path);
 
@@ -90,10 +94,33 @@ public:
     void addHook(Hook* hook);
     void removeHook(Hook* hook);
 
+    /** the change recorder is told the old value whenever a hookable
+     * attribute of this object changes. Since this requires a conversion
+     * to string, it is only set while someone records the changes.
+     */
+    Hook* changeRecorder() const { return changeRecorder_; }
+    void setChangeRecorder(Hook* recorder) { changeRecorder_ = recorder; }
+
     std::map<std::string, Object*> children();
 
+    /** call visitor(name, child) for every child, ordered by name, without
+     * copying the maps of children. As in children(), a dynamic child hides
+     * a static child of the same name unless it is currently null. The
+     * visitor must not add or remove children of this object.
+     */
+    template<typename Visitor>
+    void forEachChild(Visitor visitor);
+    size_t childCount();
+
     void printTree(Output output, std::string rootLabel);
 
+    /** a counter that increases whenever a child or an attribute is added
+     * to or removed from any object, or an object is destroyed. As long as
+     * it has the same value, static children and attributes can be looked
+     * up by a previously resolved pointer.
+     */
+    static unsigned long structureGeneration() { return structureGeneration_; }
+
 protected:
     // initialize an attribute (typically used by init())
     virtual void wireAttributes(std::vector<Attribute*> attrs);
@@ -106,8 +133,40 @@ protected:
     std::vector<Hook*> hooks_;
 
     //DynamicAttribute nameAttribute_;
+private:
+    Hook* changeRecorder_ = nullptr;
+    static unsigned long structureGeneration_;
 };
 
+template<typename Visitor>
+void Object::forEachChild(Visitor visitor)
+{
+    // merge the two maps, which are both ordered by name
+    auto staticIt = children_.begin();
+    auto dynamicIt = childrenDynamic_.begin();
+    while (staticIt != children_.end() || dynamicIt != childrenDynamic_.end()) {
+        if (dynamicIt == childrenDynamic_.end()
+            || (staticIt != children_.end() && staticIt->first < dynamicIt->first))
+        {
+            visitor(staticIt->first, staticIt->second);
+            staticIt++;
+            continue;
+        }
+        bool hidesStatic = staticIt != children_.end()
+                           && staticIt->first == dynamicIt->first;
+        Object* dynamicChild = dynamicIt->second();
+        if (dynamicChild) {
+            visitor(dynamicIt->first, dynamicChild);
+        } else if (hidesStatic) {
+            visitor(staticIt->first, staticIt->second);
+        }
+        if (hidesStatic) {
+            staticIt++;
+        }
+        dynamicIt++;
+    }
+}
+
 
 #endif
 
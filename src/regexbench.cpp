@@ -0,0 +1,87 @@
+/** A micro-benchmark of the regex backends, on the patterns and
+ * strings that herbstluftwm typically matches: window classes and
+ * types in rules and key combinations in keymasks.
+ *
+ * Build it with 'make regexbench' in the build directory.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "regexengine.h"
+
+using std::string;
+using std::vector;
+
+struct Workload {
+    const char* name;
+    vector<string> patterns;
+    vector<string> subjects;
+};
+
+static const vector<Workload> workloads = {
+    { "rules",
+        {
+            "(.*[Rr]xvt.*|.*[Tt]erm|Konsole)",
+            "_NET_WM_WINDOW_TYPE_(DIALOG|UTILITY|SPLASH)",
+            "_NET_WM_WINDOW_TYPE_(NOTIFICATION|DOCK|DESKTOP)",
+            "[Ff]irefox|[Cc]hromium",
+        },
+        {
+            "URxvt", "XTerm", "Konsole", "Firefox", "Alacritty",
+            "_NET_WM_WINDOW_TYPE_NORMAL", "_NET_WM_WINDOW_TYPE_DIALOG",
+            "_NET_WM_WINDOW_TYPE_DOCK", "Gimp-2.10", "org.gnome.Nautilus",
+        },
+    },
+    { "keymasks",
+        {
+            "^x$",
+            "Mod4-[0-9]",
+            "(Mod1|Mod4)-(Shift-)?[hjkl]",
+            "Mod4-(Shift-)?(Left|Right|Up|Down)",
+        },
+        {
+            "Mod4-Shift-q", "Mod4-Shift-r", "Mod4-Shift-c", "Mod4-Return",
+            "Mod4-Left", "Mod4-Shift-Down", "Mod4-1", "Mod4-9", "Mod4-h",
+            "Mod4-Shift-l", "Mod4-Control-Left", "Mod4-BackSpace", "x",
+        },
+    },
+};
+
+static double nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+int main(int argc, char** argv) {
+    const int repetitions = 20000;
+    for (auto backend : RegexEngine::availableBackends()) {
+        for (const auto& workload : workloads) {
+            vector<std::shared_ptr<const RegexEngine>> compiled;
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& pattern : workload.patterns) {
+                compiled.push_back(RegexEngine::compile(pattern, backend));
+            }
+            double compileTime = nanosecondsSince(start) / workload.patterns.size();
+
+            size_t matchCount = 0;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repetitions; i++) {
+                for (const auto& regex : compiled) {
+                    for (const auto& subject : workload.subjects) {
+                        matchCount += regex->fullMatch(subject) ? 1 : 0;
+                    }
+                }
+            }
+            double matchTime = nanosecondsSince(start)
+                / (repetitions * compiled.size() * workload.subjects.size());
+            printf("%-12s %-10s compile: %9.0f ns   match: %7.1f ns   (%zu matches)\n",
+                   RegexEngine::backendName(backend), workload.name,
+                   compileTime, matchTime, matchCount / repetitions);
+        }
+    }
+    return 0;
+}
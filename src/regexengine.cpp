@@ -0,0 +1,121 @@
+#include "regexengine.h"
+
+#include <regex>
+#include <stdexcept>
+
+#ifdef WITH_RE2
+#include <re2/re2.h>
+#endif
+
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+
+class StdRegexEngine : public RegexEngine {
+public:
+    StdRegexEngine(const string& source) {
+        try {
+            regex_ = std::regex(source, std::regex::extended);
+        } catch (const std::exception& e) {
+            throw std::invalid_argument(e.what());
+        }
+    }
+    bool fullMatch(const string& str) const override {
+        return std::regex_match(str, regex_);
+    }
+    bool search(const string& str) const override {
+        return std::regex_search(str, regex_);
+    }
+private:
+    std::regex regex_;
+};
+
+#ifdef WITH_RE2
+class Re2Engine : public RegexEngine {
+public:
+    Re2Engine(const string& source)
+        : regex_(source, options())
+    {
+        if (!regex_.ok()) {
+            throw std::invalid_argument(regex_.error());
+        }
+    }
+    bool fullMatch(const string& str) const override {
+        return RE2::FullMatch(str, regex_);
+    }
+    bool search(const string& str) const override {
+        return RE2::PartialMatch(str, regex_);
+    }
+private:
+    //! options that make RE2 behave like std::regex::extended
+    static RE2::Options options() {
+        RE2::Options opt;
+        opt.set_posix_syntax(true);
+        opt.set_longest_match(true);
+        // ^ and $ only match at the beginning and end of the text
+        opt.set_one_line(true);
+        // . also matches a newline
+        opt.set_dot_nl(true);
+        opt.set_log_errors(false);
+        return opt;
+    }
+    RE2 regex_;
+};
+#endif
+
+}
+
+shared_ptr<const RegexEngine> RegexEngine::compile(const string& source)
+{
+    return compile(source, defaultBackend());
+}
+
+shared_ptr<const RegexEngine> RegexEngine::compile(const string& source,
+                                                   Backend backend)
+{
+    switch (backend) {
+        case Backend::StdRegex:
+            return make_shared<StdRegexEngine>(source);
+        case Backend::RE2:
+#ifdef WITH_RE2
+            return make_shared<Re2Engine>(source);
+#else
+            break;
+#endif
+    }
+    throw std::invalid_argument(string("regex backend ")
+                                + backendName(backend)
+                                + " is not available");
+}
+
+RegexEngine::Backend RegexEngine::defaultBackend()
+{
+#ifdef WITH_RE2
+    return Backend::RE2;
+#else
+    return Backend::StdRegex;
+#endif
+}
+
+//! all available backends, ordered from the slowest to the fastest
+vector<RegexEngine::Backend> RegexEngine::availableBackends()
+{
+    return {
+        Backend::StdRegex,
+#ifdef WITH_RE2
+        Backend::RE2,
+#endif
+    };
+}
+
+const char* RegexEngine::backendName(Backend backend)
+{
+    switch (backend) {
+        case Backend::StdRegex: return "std::regex";
+        case Backend::RE2: return "RE2";
+    }
+    return "unknown";
+}
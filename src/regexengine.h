@@ -0,0 +1,35 @@
+#ifndef __HLWM_REGEXENGINE_H_
+#define __HLWM_REGEXENGINE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** A precompiled regular expression in the POSIX extended syntax
+ * that is matched against entire strings or searched in them. There are several
+ * backends implementing it; which of them are available is decided
+ * at build time.
+ */
+class RegexEngine {
+public:
+    enum class Backend {
+        StdRegex, //! std::regex, always available
+        RE2, //! RE2, a DFA based engine without backtracking
+    };
+    virtual ~RegexEngine() = default;
+    virtual bool fullMatch(const std::string& str) const = 0;
+    //! whether the regex matches somewhere in the string, like regexec()
+    virtual bool search(const std::string& str) const = 0;
+
+    /** compile the given regex with the fastest available backend.
+     * Throws std::invalid_argument if the regex is malformed.
+     */
+    static std::shared_ptr<const RegexEngine> compile(const std::string& source);
+    static std::shared_ptr<const RegexEngine> compile(const std::string& source,
+                                                      Backend backend);
+    static Backend defaultBackend();
+    static std::vector<Backend> availableBackends();
+    static const char* backendName(Backend backend);
+};
+
+#endif
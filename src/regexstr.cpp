@@ -15,11 +15,7 @@ RegexStr RegexStr::fromStr(const string& source)
     // https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/V1_chap09.html#tag_09_05_03
     // => So we must not compile "" to a regex
     if (!source.empty()) {
-        try {
-            r.regex_ = std::regex(source, std::regex::extended);
-        }  catch (const std::exception& e) {
-            throw std::invalid_argument(e.what());
-        }
+        r.regex_ = RegexEngine::compile(source);
     }
     return r;
 }
@@ -34,7 +30,7 @@ bool RegexStr::matches(const string& str) const
     if (source_.empty()) {
         return false;
     } else {
-        return std::regex_match(str, regex_);
+        return regex_->fullMatch(str);
     }
 }
 
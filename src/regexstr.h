@@ -1,13 +1,16 @@
 #ifndef REGEXSTR_H
 #define REGEXSTR_H
 
-#include <regex>
+#include <memory>
+#include <string>
 
 #include "attribute_.h"
 #include "converter.h"
+#include "regexengine.h"
 
 /** wrapper class for extended regexes that remembers
- * its source string
+ * its source string. The compiled regex is shared among
+ * copies, so copying a RegexStr is cheap.
  */
 class RegexStr
 {
@@ -31,7 +34,7 @@ public:
     bool matches(const std::string& str) const;
 private:
     std::string source_;
-    std::regex regex_;
+    std::shared_ptr<const RegexEngine> regex_;
 };
 
 template<> RegexStr Converter<RegexStr>::parse(const std::string& source);
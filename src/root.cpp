@@ -2,11 +2,13 @@
 
 #include <memory>
 
+#include "attributejournal.h"
 #include "client.h"
 #include "clientmanager.h"
 #include "ewmh.h"
 #include "globalcommands.h"
 #include "hlwmcommon.h"
+#include "hookcoalescer.h"
 #include "keymanager.h"
 #include "layout.h"
 #include "metacommands.h"
@@ -15,6 +17,7 @@
 #include "panelmanager.h"
 #include "rulemanager.h"
 #include "settings.h"
+#include "statistics.h"
 #include "tag.h"
 #include "tagmanager.h"
 #include "theme.h"
@@ -29,12 +32,14 @@ shared_ptr<Root> Root::root_;
 
 Root::Root(Globals g, XConnection& xconnection, Ewmh& ewmh, IpcServer& ipcServer)
     : clients(*this, "clients")
+    , journal(*this, "journal")
     , keys(*this, "keys")
     , monitors(*this, "monitors")
     , mouse(*this, "mouse")
     , panels(*this, "panels")
     , rules(*this, "rules")
     , settings(*this, "settings")
+    , stats(*this, "stats")
     , tags(*this, "tags")
     , theme(*this, "theme")
     , tmp(*this, TMP_OBJECT_PATH)
@@ -43,18 +48,21 @@ Root::Root(Globals g, XConnection& xconnection, Ewmh& ewmh, IpcServer& ipcServer
     , globals(g)
     , meta_commands(make_unique<MetaCommands>(*this))
     , global_commands(make_unique<GlobalCommands>(*this))
+    , hookCoalescer(make_unique<HookCoalescer>(ipcServer, timers))
     , X(xconnection)
     , ipcServer_(ipcServer)
     , ewmh_(ewmh)
 {
     // initialize root children (alphabetically)
     clients.init();
-    keys.init();
+    journal.init();
+    keys.init(timers);
     monitors.init();
     mouse.init();
     panels.init(xconnection);
     rules.init();
     settings.init();
+    stats.init(xconnection, ipcServer, *hookCoalescer, *monitors());
     tags.init();
     theme.init();
     tmp.init();
@@ -70,6 +78,7 @@ Root::Root(Globals g, XConnection& xconnection, Ewmh& ewmh, IpcServer& ipcServer
     monitors->injectDependencies(settings(), tags(), panels());
     mouse->injectDependencies(clients(), monitors());
     watchers->injectDependencies(this);
+    hookCoalescer->injectDependencies(settings());
 
     // set temporary globals
     ::global_tags = tags();
@@ -83,6 +92,9 @@ Root::Root(Globals g, XConnection& xconnection, Ewmh& ewmh, IpcServer& ipcServer
     });
     theme->theme_changed_.connect(monitors(), &MonitorManager::relayoutAll);
     panels->panels_changed_.connect(monitors(), &MonitorManager::autoUpdatePads);
+
+    // the journal follows the object tree, so it needs to be complete
+    journal->injectDependencies(this);
 }
 
 Root::~Root() {
@@ -90,6 +102,8 @@ Root::~Root() {
 
 void Root::shutdown()
 {
+    // the journal hooks all objects, so it goes first
+    journal.reset();
     // Note: delete in reverse order of initialization!
     mouse.reset();
     // ClientManager and MonitorManager have circular dependencies, but only
@@ -106,6 +120,7 @@ void Root::shutdown()
     keys.reset();
     rules.reset();
     settings.reset();
+    stats.reset();
     theme.reset();
     tmp.reset();
 
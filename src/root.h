@@ -5,14 +5,17 @@
 
 #include "child.h"
 #include "object.h"
+#include "timerqueue.h"
 
 // new object tree root.
 
+class AttributeJournal; // IWYU pragma: keep
 class ClientManager; // IWYU pragma: keep
 class Ewmh;
 class FrameLeaf;
 class GlobalCommands;
 class HlwmCommon;
+class HookCoalescer;
 class IpcServer;
 class KeyManager; // IWYU pragma: keep
 class MonitorManager; // IWYU pragma: keep
@@ -21,6 +24,7 @@ class PanelManager;
 class MetaCommands;
 class RuleManager; // IWYU pragma: keep
 class Settings; // IWYU pragma: keep
+class Statistics; // IWYU pragma: keep
 class TagManager; // IWYU pragma: keep
 class Theme; // IWYU pragma: keep
 class Tmp; // IWYU pragma: keep
@@ -53,12 +57,14 @@ public:
 
     // (in alphabetical order)
     Child_<ClientManager> clients;
+    Child_<AttributeJournal> journal;
     Child_<KeyManager> keys;
     Child_<MonitorManager> monitors;
     Child_<MouseManager> mouse;
     Child_<PanelManager> panels;
     Child_<RuleManager> rules;
     Child_<Settings> settings;
+    Child_<Statistics> stats;
     Child_<TagManager> tags;
     Child_<Theme> theme;
     Child_<Tmp> tmp;
@@ -66,8 +72,10 @@ public:
     Child_<Watchers> watchers;
 
     Globals globals;
+    TimerQueue timers; // driven by the main loop
     std::unique_ptr<MetaCommands> meta_commands; // Using "pimpl" to avoid include
     std::unique_ptr<GlobalCommands> global_commands; // Using "pimpl" to avoid include
+    std::unique_ptr<HookCoalescer> hookCoalescer; // Using "pimpl" to avoid include
     XConnection& X;
     IpcServer& ipcServer_;
     //! Temporary member. In the long run, ewmh should get its information
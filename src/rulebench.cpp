@@ -0,0 +1,135 @@
+/** A micro-benchmark of RuleManager::evaluateRules() on a synthetic rule
+ * set that mixes rules with an exact first condition (which are indexed)
+ * and other rules. Clients can only be created on an X display, so run
+ * it on a spare X server, e.g.:
+ *
+ *     Xvfb :9 & DISPLAY=:9 ./rulebench
+ *
+ * Build it with 'make rulebench' in the build directory.
+ */
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "client.h"
+#include "clientmanager.h"
+#include "ewmh.h"
+#include "fontdata.h"
+#include "ipc-server.h"
+#include "monitormanager.h"
+#include "root.h"
+#include "rulemanager.h"
+#include "xconnection.h"
+
+using std::string;
+using std::vector;
+
+// these are defined in main.cpp, which is not linked into the benchmark
+int g_verbose = 0;
+Display* g_display = nullptr;
+Window g_root = 0;
+
+static const vector<vector<string>> templates = {
+    { "class=class{}", "pseudotile=on" },
+    { "instance=inst{}", "ewmhnotify=off" },
+    { "title~title{}.*", "floating=off" },
+    { "not", "windowrole=role{}", "class=nomatch{}", "fullscreen=off" },
+    { "windowtype=_NET_WM_WINDOW_TYPE_SPLASH", "instance=inst{}", "focus=on" },
+    { "pid=99{}", "ewmhrequests=on" },
+};
+
+//! replace the placeholder {} in the template by the given number
+static string instantiate(string arg, int number) {
+    auto pos = arg.find("{}");
+    if (pos != string::npos) {
+        arg.replace(pos, 2, std::to_string(number));
+    }
+    return arg;
+}
+
+static void addRules(RuleManager& rules, int count) {
+    std::ostringstream output;
+    rules.unruleCommand(Input("unrule", {"--all"}), output);
+    for (int i = 0; i < count - 1; i++) {
+        vector<string> args;
+        for (const auto& arg : templates[i % templates.size()]) {
+            args.push_back(instantiate(arg, i));
+        }
+        rules.addRuleCommand(Input("rule", args), output);
+    }
+    rules.addRuleCommand(Input("rule", {"class=class7", "tag=bench"}), output);
+}
+
+static Window createWindow(XConnection& X, int number) {
+    Window win = XCreateSimpleWindow(X.display(), X.root(), 0, 0, 100, 100, 0, 0, 0);
+    string instance = "inst" + std::to_string(number);
+    string windowClass = "class" + std::to_string(number);
+    XClassHint hint;
+    hint.res_name = &instance[0];
+    hint.res_class = &windowClass[0];
+    XSetClassHint(X.display(), win, &hint);
+    return win;
+}
+
+static double nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+int main(int argc, char** argv) {
+    XConnection* X = XConnection::connect();
+    g_display = X->display();
+    if (!g_display) {
+        fprintf(stderr, "rulebench: cannot open display\n");
+        delete X;
+        return 1;
+    }
+    g_root = X->root();
+    Ewmh* ewmh = new Ewmh(*X);
+    ewmh->installWmWindow();
+    FontData::s_xconnection = X;
+    IpcServer* ipcServer = new IpcServer(*X);
+    auto root = std::make_shared<Root>(Globals(), *X, *ewmh, *ipcServer);
+    Root::setRoot(root);
+    root->monitors()->ensure_monitors_are_available();
+
+    vector<Client*> clients;
+    for (int i = 5; i < 10; i++) {
+        Client* client = root->clients()->manage_client(createWindow(*X, i), false, false);
+        if (client) {
+            clients.push_back(client);
+        }
+    }
+
+    const int repetitions = 2000;
+    for (int ruleCount : {60, 600, 6000}) {
+        addRules(*root->rules(), ruleCount);
+        std::ostringstream output;
+        size_t tagged = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            for (auto client : clients) {
+                auto changes = root->rules()->evaluateRules(client, output);
+                tagged += changes.tag_name.empty() ? 0 : 1;
+            }
+        }
+        double duration = nanosecondsSince(start) / (repetitions * clients.size());
+        printf("%5d rules, %zu clients: %9.0f ns per evaluateRules()   (%zu tagged)\n",
+               ruleCount, clients.size(), duration, tagged / repetitions);
+    }
+
+    root->shutdown();
+    root.reset();
+    Root::setRoot(root);
+    FontData::s_xconnection = nullptr;
+    delete ipcServer;
+    delete ewmh;
+    delete X;
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <string>
 
+#include "client.h"
 #include "completion.h"
 #include "globals.h"
 #include "ipc-protocol.h"
@@ -12,6 +13,7 @@ using std::string;
 using std::to_string;
 using std::endl;
 using std::unique_ptr;
+using std::vector;
 
 /**
  * @brief RuleManager::parseRule
@@ -132,6 +134,7 @@ int RuleManager::addRuleCommand(Input input, Output output) {
     // Insert rule into list according to "prepend" flag
     auto insertAt = prepend ? rules_.begin() : rules_.end();
     rules_.insert(insertAt, make_unique<Rule>(rule));
+    indexDirty_ = true;
 
     return HERBST_EXIT_SUCCESS;
 }
@@ -147,6 +150,7 @@ int RuleManager::unruleCommand(Input input, Output output) {
 
     if (arg == "--all" || arg == "-F") {
         rules_.clear();
+        indexDirty_ = true;
         rule_label_index_ = 0;
     } else {
         // Remove rule specified by argument
@@ -188,6 +192,7 @@ size_t RuleManager::removeRules(string label) {
     }
 
     auto countAfter = rules_.size();
+    indexDirty_ = true;
 
     return countAfter - countBefore;
 }
@@ -229,18 +234,102 @@ void RuleManager::addRuleCompletion(Completion& complete) {
 }
 
 
+/*!
+ * Rebuild the index of the rules by their first condition. The
+ * index is rebuilt lazily on the first evaluation after the set of
+ * rules changed.
+ */
+void RuleManager::rebuildIndex() {
+    classIndex_.clear();
+    instanceIndex_.clear();
+    windowtypeIndex_.clear();
+    unindexedRules_.clear();
+    size_t position = 0;
+    for (auto& rule : rules_) {
+        auto entry = std::make_pair(position++, rule.get());
+        // a rule with a maxage condition needs to be evaluated for
+        // every client, because it may expire even if it does not match
+        bool hasMaxage = std::any_of(rule->conditions.begin(), rule->conditions.end(),
+                                     [](const Condition& cond) {
+                                         return cond.isMaxage();
+                                     });
+        if (rule->conditions.empty() || hasMaxage) {
+            unindexedRules_.push_back(entry);
+            continue;
+        }
+        const Condition& first = rule->conditions.front();
+        if (first.negated || first.value_type != CONDITION_VALUE_TYPE_STRING) {
+            unindexedRules_.push_back(entry);
+        } else if (first.name == "class") {
+            classIndex_[first.value_str].push_back(entry);
+        } else if (first.name == "instance") {
+            instanceIndex_[first.value_str].push_back(entry);
+        } else if (first.name == "windowtype") {
+            windowtypeIndex_[first.value_str].push_back(entry);
+        } else {
+            unindexedRules_.push_back(entry);
+        }
+    }
+    indexDirty_ = false;
+}
+
+/*!
+ * Call onRule for all rules that possibly match the given client,
+ * ordered by their position in the list of rules. The unindexed rules
+ * and each bucket are already sorted by position, so they are merged
+ * without copying or sorting them.
+ */
+void RuleManager::forEachCandidate(const Client* client, std::function<void(Rule*)> onRule) {
+    if (indexDirty_) {
+        rebuildIndex();
+    }
+    using Range = std::pair<vector<IndexEntry>::const_iterator,
+                            vector<IndexEntry>::const_iterator>;
+    vector<Range> ranges = { {unindexedRules_.begin(), unindexedRules_.end()} };
+    auto addBucket = [&ranges](const RuleIndex& index, const string& value) {
+        auto it = index.find(value);
+        if (it != index.end()) {
+            ranges.push_back({it->second.begin(), it->second.end()});
+        }
+    };
+    addBucket(classIndex_, client->window_class_());
+    addBucket(instanceIndex_, client->window_instance_());
+    addBucket(windowtypeIndex_, client->window_type_());
+    while (true) {
+        // pick the range whose next rule comes first. A rule is in at
+        // most one range, and there are at most four ranges.
+        Range* next = nullptr;
+        for (auto& range : ranges) {
+            if (range.first != range.second
+                && (!next || range.first->first < next->first->first))
+            {
+                next = &range;
+            }
+        }
+        if (!next) {
+            break;
+        }
+        onRule(next->first->second);
+        next->first++;
+    }
+}
+
 //! Evaluate rules against a given client
 ClientChanges RuleManager::evaluateRules(Client* client, Output output, ClientChanges changes) {
-    // go through all rules and remove those that expired.
-    // Here, we use erase + remove_if because it uses a Forward Iterator
-    // and so it is ensured that the rules are evaluated in the correct order.
-    auto forEachRule = [&](unique_ptr<Rule>& rule) {
+    // only the candidate rules can match, so the others can be skipped
+    // without changing the result. The candidates are evaluated in the
+    // order of the rules.
+    bool anyExpired = false;
+    forEachCandidate(client, [&](Rule* rule) {
         rule->evaluate(client, changes, output);
-        return rule->expired();
-    };
-    rules_.erase(std::remove_if(rules_.begin(), rules_.end(), forEachRule),
-                 rules_.end());
+        anyExpired = anyExpired || rule->expired();
+    });
+    if (anyExpired) {
+        // remove the expired rules.
+        rules_.remove_if([](const unique_ptr<Rule>& rule) {
+            return rule->expired();
+        });
+        indexDirty_ = true;
+    }
     return changes;
 }
-
-
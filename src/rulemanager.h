@@ -1,7 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "object.h"
 #include "rules.h"
@@ -19,10 +22,29 @@ public:
 private:
     size_t removeRules(std::string label);
     static std::tuple<std::string, char, std::string> tokenizeArg(std::string arg);
+    //! a rule together with its position in rules_
+    using IndexEntry = std::pair<size_t, Rule*>;
+    using RuleIndex = std::unordered_map<std::string, std::vector<IndexEntry>>;
+    void rebuildIndex();
+    void forEachCandidate(const Client* client, std::function<void(Rule*)> onRule);
 
     //! Ever-incrementing index for labeling new rules
     unsigned long long rule_label_index_ = 0;
 
     //! Currently active rules
     std::list<std::unique_ptr<Rule>> rules_;
+
+    /*! An index on rules_ that allows to skip most of the rules that
+     * can not match a client. A rule whose first condition is an exact
+     * match on the class, instance, or window type is filed under the
+     * respective value; all other rules can match any client. Each
+     * entry carries the rule's position in rules_, so the candidate
+     * rules can be evaluated in the original order.
+     */
+    RuleIndex classIndex_;
+    RuleIndex instanceIndex_;
+    RuleIndex windowtypeIndex_;
+    std::vector<IndexEntry> unindexedRules_;
+    //! whether rules_ changed since the index was built
+    bool indexDirty_ = true;
 };
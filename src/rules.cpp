@@ -4,11 +4,8 @@
 #include <cstdio>
 
 #include "client.h"
-#include "ewmh.h"
 #include "hook.h"
-#include "root.h"
 #include "utils.h"
-#include "xconnection.h"
 
 using std::string;
 
@@ -43,19 +40,25 @@ const std::map<string, Consequence::Applier> Consequence::appliers = {
     { "floatplacement", &Consequence::applyFloatplacement  },
 };
 
+/**
+ * Add condition to this rule. The name has to be one of Condition::matchers.
+ *
+ * @retval false if the condition cannot be added (malformed)
+ */
 bool Rule::addCondition(string name, char op, const char* value, bool negated, Output output) {
     Condition cond;
     cond.negated = negated;
+    cond.matcher = Condition::matchers.at(name);
 
     cond.conditionCreationTime = get_monotonic_timestamp();
 
-    if (op != '=' && name == "maxage") {
+    if (op != '=' && cond.isMaxage()) {
         output << "rule: Condition maxage only supports the = operator\n";
         return false;
     }
     switch (op) {
         case '=': {
-            if (name == "maxage") {
+            if (cond.isMaxage()) {
                 cond.value_type = CONDITION_VALUE_TYPE_INTEGER;
                 if (1 != sscanf(value, "%d", &cond.value_integer)) {
                     output << "rule: Cannot parse integer from \"" << value << "\"\n";
@@ -71,14 +74,13 @@ bool Rule::addCondition(string name, char op, const char* value, bool negated, O
         case '~': {
             cond.value_type = CONDITION_VALUE_TYPE_REGEX;
             try {
-                cond.value_reg_exp = std::regex(value, std::regex::extended);
-            } catch(std::regex_error& err) {
+                cond.value_reg_exp = RegexStr::fromStr(value);
+            } catch(std::invalid_argument& err) {
                 output << "rule: Cannot parse value \"" << value
                         << "\" from condition \"" << name
                         << "\": \"" << err.what() << "\"\n";
                 return false;
             }
-            cond.value_reg_str = value;
             break;
         }
 
@@ -95,12 +97,14 @@ bool Rule::addCondition(string name, char op, const char* value, bool negated, O
 }
 
 /**
- * Add consequence to this rule.
+ * Add consequence to this rule. The name has to be one of
+ * Consequence::appliers.
  *
  * @retval false if the consequence cannot be added (malformed)
  */
 bool Rule::addConsequence(string name, char op, const char* value, Output output) {
     Consequence cons;
+    cons.applier = Consequence::appliers.at(name);
     switch (op) {
         case '=':
             cons.value_type = CONSEQUENCE_VALUE_TYPE_STRING;
@@ -152,15 +156,15 @@ bool Rule::evaluate(Client* client, ClientChanges& changes, Output output)
 
     // check all conditions
     for (auto& cond : conditions) {
-        if (!rule_match && cond.name != "maxage") {
+        if (!rule_match && !cond.isMaxage()) {
             // implement lazy AND &&
             // ... except for maxage
             continue;
         }
 
-        bool matches = Condition::matchers.at(cond.name)(&cond, client);
+        bool matches = cond.matches(client);
 
-        if (!matches && !cond.negated && cond.name == "maxage")
+        if (!matches && !cond.negated && cond.isMaxage())
         {
             // if not negated maxage does not match anymore
             // then it will never match again in the future
@@ -177,7 +181,7 @@ bool Rule::evaluate(Client* client, ClientChanges& changes, Output output)
         // apply all consequences
         for (auto& cons : consequences) {
             try {
-                Consequence::appliers.at(cons.name)(&cons, client, &changes);
+                cons.apply(client, &changes);
             } catch (std::exception& e) {
                 output << "Invalid argument \"" << cons.value
                        << "\" for rule consequence \"" << cons.name << "\": "
@@ -205,7 +209,7 @@ void Rule::print(Output output) {
                 output << "=" << cond.value_str << "\t";
                 break;
             case CONDITION_VALUE_TYPE_REGEX:
-                output << "~" << cond.value_reg_str << "\t";
+                output << "~" << cond.value_reg_exp.str() << "\t";
                 break;
             default: /* CONDITION_VALUE_TYPE_INTEGER: */
                 output << "=" << cond.value_integer << "\t";
@@ -233,7 +237,11 @@ bool Condition::matches(const string& str) const {
             return value_str == str;
             break;
         case CONDITION_VALUE_TYPE_REGEX:
-            return std::regex_match(str, value_reg_exp);
+            if (value_reg_exp.empty()) {
+                // the empty regex only matches the empty string
+                return str.empty();
+            }
+            return value_reg_exp.matches(str);
             break;
         case CONDITION_VALUE_TYPE_INTEGER:
             try {
@@ -247,11 +255,11 @@ bool Condition::matches(const string& str) const {
 }
 
 bool Condition::matchesClass(const Client* client) const {
-    return matches(Root::get()->X.getClass(client->window_));
+    return matches(client->window_class_());
 }
 
 bool Condition::matchesInstance(const Client* client) const {
-    return matches(Root::get()->X.getInstance(client->window_));
+    return matches(client->window_instance_());
 }
 
 bool Condition::matchesTitle(const Client* client) const {
@@ -290,23 +298,17 @@ bool Condition::matchesMaxage(const Client* client) const {
 }
 
 bool Condition::matchesWindowtype(const Client* client) const {
-    auto& ewmh = Ewmh::get();
-    int wintype = ewmh.getWindowType(client->x11Window());
-    if (wintype < 0) {
+    if (client->window_type_().empty()) {
         return false;
     }
-    return matches(ewmh.netatomName(wintype));
+    return matches(client->window_type_());
 }
 
 bool Condition::matchesWindowrole(const Client* client) const {
-    auto& X = Root::get()->X;
-    auto role = X.getWindowProperty(client->window_, X.atom("WM_WINDOW_ROLE"));
-
-    if (!role.has_value()) {
+    if (!client->has_window_role_) {
         return false;
     }
-
-    return matches(role.value());
+    return matches(client->window_role_());
 }
 
 /// CONSEQUENCES ///
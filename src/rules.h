@@ -2,7 +2,6 @@
 #define __HS_RULES_H_
 
 #include <functional>
-#include <regex>
 
 #include "converter.h"
 #include "finite.h"
@@ -24,17 +23,17 @@ enum {
 class Condition {
 public:
 
-    using Matcher = std::function<bool(const Condition*, const Client*)>;
+    using Matcher = bool (Condition::*)(const Client*) const;
     static const std::map<std::string, Matcher> matchers;
 
     std::string name;
+    Matcher matcher = nullptr; // resolved from the name when adding the condition
     int value_type = 0;
     bool negated = false;
 
     std::string value_str;
     int value_integer = 0;
-    std::regex value_reg_exp;
-    std::string value_reg_str;
+    RegexStr value_reg_exp;
 
     /*! Timestamp of when this condition (i.e. rule) was created, which is
      * needed for the maxage matcher.
@@ -45,6 +44,13 @@ public:
      */
     time_t conditionCreationTime = 0;
 
+    bool matches(const Client* client) const {
+        return (this->*matcher)(client);
+    }
+    bool isMaxage() const {
+        return matcher == &Condition::matchesMaxage;
+    }
+
 private:
     bool matchesClass(const Client* client) const;
     bool matchesInstance(const Client* client) const;
@@ -105,13 +111,18 @@ public:
      * exception (std::invalid_argument, std::out_of_range) if the value in the
      * Consequence object is invalid.
      */
-    using Applier = std::function<void(const Consequence*, const Client*, ClientChanges*)>;
+    using Applier = void (Consequence::*)(const Client*, ClientChanges*) const;
     static const std::map<std::string, Applier> appliers;
 
     std::string name;
+    Applier applier = nullptr; // resolved from the name when adding the consequence
     int value_type = 0;
     std::string value;
 
+    void apply(const Client* client, ClientChanges* changes) const {
+        (this->*applier)(client, changes);
+    }
+
 private:
     void applyTag(const Client* client, ClientChanges* changes) const;
     void applyIndex(const Client* client, ClientChanges* changes) const;
@@ -1,12 +1,14 @@
 #include "settings.h"
 
 #include <sstream>
+#include <vector>
 
 #include "client.h"
 #include "completion.h"
 #include "ewmh.h"
 #include "framedata.h"
 #include "ipc-protocol.h"
+#include "layout.h"
 #include "monitormanager.h"
 #include "root.h"
 #include "utils.h"
@@ -15,6 +17,7 @@ using std::endl;
 using std::function;
 using std::string;
 using std::to_string;
+using std::vector;
 
 Settings* g_settings = nullptr; // the global settings object
 
@@ -80,6 +83,8 @@ Settings::Settings()
         &update_dragged_clients,
         &tree_style,
         &wmname,
+        &hook_coalesce_ms,
+        &hook_coalesce_hooks,
 
         &window_border_width,
         &window_border_inner_width,
@@ -88,6 +93,17 @@ Settings::Settings()
         &window_border_normal_color,
         &window_border_urgent_color,
     });
+    // the cached layouts of the frames depend on these, so invalidate
+    // them before the layout is applied again:
+    for (Attribute* i : vector<Attribute*>{&frame_gap,
+         &frame_padding,
+         &window_gap,
+         &frame_border_width,
+         &gapless_grid,
+         &smart_frame_surroundings,
+         &smart_window_surroundings}) {
+        i->changed().connect(&Frame::invalidateAllLayouts);
+    }
     for (auto i : {&frame_gap, &frame_padding, &window_gap}) {
         i->changed().connect([] { all_monitors_apply_layout(); });
     }
@@ -137,10 +153,9 @@ Settings::Settings()
 void Settings::injectDependencies(Root* root) {
     root_ = root;
     // TODO: the lock level is not a setting! should move somewhere else
+    // if the monitors get unlocked, then the dirty monitors are
+    // relayouted by MonitorManager::applyDirtyLayouts()
     monitors_locked = root->globals.initial_monitors_locked;
-    monitors_locked.changed().connect([root](bool) {
-        root->monitors()->lock_number_changed();
-    });
 }
 
 function<int()> Settings::getIntAttr(string name) {
@@ -8,6 +8,7 @@
 #include "framedata.h"
 #include "globals.h"
 #include "object.h"
+#include "regexstr.h"
 #include "x11-types.h"
 
 class Root;
@@ -66,6 +67,8 @@ public:
     Attribute_<bool>          update_dragged_clients = {"update_dragged_clients", false};
     Attribute_<string>        tree_style = {"tree_style", "*| +`--."};
     Attribute_<string>        wmname = {"wmname", WINDOW_MANAGER_NAME};
+    Attribute_<unsigned long> hook_coalesce_ms = {"hook_coalesce_ms", 0};
+    Attribute_<RegexStr>      hook_coalesce_hooks = {"hook_coalesce_hooks", RegexStr::fromStr("window_title_changed")};
     // for compatibility
     DynAttribute_<int>         window_border_width;
     DynAttribute_<int>         window_border_inner_width;
@@ -0,0 +1,49 @@
+#include "statistics.h"
+
+#include "hookcoalescer.h"
+#include "ipc-server.h"
+#include "monitormanager.h"
+#include "xconnection.h"
+
+Statistics::Statistics(XConnection& xcon, IpcServer& ipcServer,
+                       HookCoalescer& hookCoalescer, MonitorManager& monitors)
+    : atom_cache_misses(this, "atom_cache_misses",
+                        [&xcon]() { return xcon.atomCacheMisses(); })
+    , hooks_emitted(this, "hooks_emitted", [&ipcServer]() {
+        return static_cast<unsigned long>(ipcServer.socketServer().hooksEmitted());
+    })
+    , hooks_delivered(this, "hooks_delivered", [&ipcServer]() {
+        return ipcServer.socketServer().hooksDelivered();
+    })
+    , hooks_dropped(this, "hooks_dropped", [&ipcServer]() {
+        return ipcServer.socketServer().hooksDropped();
+    })
+    , hooks_suppressed(this, "hooks_suppressed", [&hookCoalescer]() {
+        return hookCoalescer.suppressed();
+    })
+    , relayouts(this, "relayouts", [&monitors]() {
+        return monitors.relayouts();
+    })
+{
+    setDoc("Counters on the internal behaviour of herbstluftwm.");
+    atom_cache_misses.setDoc(
+        "the number of X atoms that were not known in advance "
+        "and thus required a round trip to the X server");
+    hooks_emitted.setDoc(
+        "the number of hooks emitted so far, which is also the "
+        "sequence number of the most recent hook");
+    hooks_delivered.setDoc(
+        "the number of hooks sent to the subscribers of the hook "
+        "stream on the unix socket");
+    hooks_dropped.setDoc(
+        "the number of hooks that subscribers of the hook stream "
+        "missed because they did not read them fast enough or resumed "
+        "from a hook that is no longer in the backlog");
+    hooks_suppressed.setDoc(
+        "the number of hooks that were not emitted because a more recent "
+        "hook of the same kind replaced them, see the setting "
+        "hook_coalesce_ms");
+    relayouts.setDoc(
+        "the number of times a monitor was laid out, i.e. its clients "
+        "and frames were arranged");
+}
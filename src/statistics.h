@@ -0,0 +1,25 @@
+#pragma once
+
+#include "attribute_.h"
+#include "object.h"
+
+class HookCoalescer;
+class IpcServer;
+class MonitorManager;
+class XConnection;
+
+/**
+ * @brief Read-only counters exposing internals of herbstluftwm that
+ * are relevant for its performance.
+ */
+class Statistics : public Object {
+public:
+    Statistics(XConnection& xcon, IpcServer& ipcServer, HookCoalescer& hookCoalescer,
+               MonitorManager& monitors);
+    DynAttribute_<unsigned long> atom_cache_misses;
+    DynAttribute_<unsigned long> hooks_emitted;
+    DynAttribute_<unsigned long> hooks_delivered;
+    DynAttribute_<unsigned long> hooks_dropped;
+    DynAttribute_<unsigned long> hooks_suppressed;
+    DynAttribute_<unsigned long> relayouts;
+};
@@ -73,7 +73,10 @@ DecorationScheme::DecorationScheme()
     for (auto i : proxyAttributes_) {
         addAttribute(i->toAttribute());
         i->toAttribute()->setWritable();
-        i->toAttribute()->changed().connect([this]() { this->scheme_changed_.emit(); });
+        i->toAttribute()->changed().connect([this]() {
+            this->revision_++;
+            this->scheme_changed_.emit();
+        });
     }
     border_width.setDoc("the base width of the border");
     padding_top.setDoc("additional border width on the top");
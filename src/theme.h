@@ -95,6 +95,8 @@ public:
     AttributeProxy_<Color>   background_color = {"background_color", {"black"}}; // color behind client contents
 
     Signal scheme_changed_; //! whenever one of the attributes changes.
+    //! a counter that is increased whenever one of the attributes changes
+    unsigned long revision() const { return revision_; }
 
     Rectangle inner_rect_to_outline(Rectangle rect) const;
     Rectangle outline_to_inner_rect(Rectangle rect) const;
@@ -107,6 +109,7 @@ private:
     std::string resetSetterHelper(std::string dummy);
     std::string resetGetterHelper();
     std::vector<ProxyAddTargetInterface*> proxyAttributes_;
+    unsigned long revision_ = 0;
 };
 
 class DecTriple : public DecorationScheme {
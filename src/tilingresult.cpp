@@ -19,3 +19,11 @@ void TilingResult::mergeFrom(TilingResult& other) {
     data.splice(data.end(), other.data);
     frames.splice(frames.end(), other.frames);
 }
+
+void TilingResult::appendTo(TilingResult& target) const {
+    target.data.insert(target.data.end(), data.begin(), data.end());
+    target.frames.insert(target.frames.end(), frames.begin(), frames.end());
+    for (const auto& child : children) {
+        child->appendTo(target);
+    }
+}
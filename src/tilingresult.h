@@ -2,6 +2,8 @@
 #define __HLWM_TILINGSTEP_H_
 
 #include <list>
+#include <memory>
+#include <vector>
 
 #include "framedecoration.h"
 #include "x11-types.h"
@@ -34,9 +36,15 @@ public:
 
     // merge all the tiling steps from other into this
     void mergeFrom(TilingResult& other);
+    // append the tiling steps of this and of all children to target
+    void appendTo(TilingResult& target) const;
 
     std::list<std::pair<FrameDecoration*,FrameDecorationData>> frames;
     std::list<std::pair<Client*,TilingStep>> data;
+    // the results of the subtrees, which come after the tiling steps of
+    // this. They are shared with the layout caches of the frames and
+    // thus must not be modified.
+    std::vector<std::shared_ptr<const TilingResult>> children;
 };
 
 
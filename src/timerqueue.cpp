@@ -0,0 +1,46 @@
+#include "timerqueue.h"
+
+using std::chrono::milliseconds;
+using std::function;
+
+TimerQueue::TimerId TimerQueue::schedule(milliseconds delay, function<void()> callback)
+{
+    TimerId id = nextId_++;
+    timers_.emplace(Clock::now() + delay, Timer { id, callback });
+    return id;
+}
+
+void TimerQueue::cancel(TimerId id)
+{
+    for (auto it = timers_.begin(); it != timers_.end(); it++) {
+        if (it->second.id == id) {
+            timers_.erase(it);
+            return;
+        }
+    }
+}
+
+std::experimental::optional<milliseconds> TimerQueue::timeUntilNext() const
+{
+    if (timers_.empty()) {
+        return {};
+    }
+    auto remaining = timers_.begin()->first - Clock::now();
+    if (remaining <= Clock::duration::zero()) {
+        return milliseconds(0);
+    }
+    // round up, such that the main loop does not wake up too early
+    return std::chrono::duration_cast<milliseconds>(remaining) + milliseconds(1);
+}
+
+void TimerQueue::runExpired()
+{
+    // timers scheduled by the callbacks do not expire in this run, even if
+    // their delay is zero
+    auto now = Clock::now();
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+        auto callback = timers_.begin()->second.callback;
+        timers_.erase(timers_.begin());
+        callback();
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+
+#include "optional.h"
+
+/**
+ * Callbacks that are run once at a given point in time. The main loop
+ * waits for events at most until the next timer expires and then runs
+ * the callbacks of all expired timers.
+ */
+class TimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = unsigned long;
+    //! run the callback after the given delay
+    TimerId schedule(std::chrono::milliseconds delay, std::function<void()> callback);
+    //! remove the given timer, if it did not expire yet
+    void cancel(TimerId id);
+    //! the time until the next timer expires, or nothing if there is none
+    std::experimental::optional<std::chrono::milliseconds> timeUntilNext() const;
+    void runExpired();
+private:
+    class Timer {
+    public:
+        TimerId id;
+        std::function<void()> callback;
+    };
+    std::multimap<Clock::time_point, Timer> timers_;
+    TimerId nextId_ = 1;
+};
@@ -275,3 +275,17 @@ void posix_sh_compress_inplace(char* str) {
     }
 }
 
+string tab_field_escape(const string& source) {
+    string target;
+    target.reserve(source.size());
+    for (char ch : source) {
+        switch (ch) {
+            case '\\': target += "\\\\"; break;
+            case '\t': target += "\\t"; break;
+            case '\n': target += "\\n"; break;
+            default: target += ch; break;
+        }
+    }
+    return target;
+}
+
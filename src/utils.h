@@ -83,6 +83,9 @@ std::string utf8_string_at(const std::string& str, size_t offset);
 std::string posix_sh_escape(const std::string& source);
 // does the reverse action to posix_sh_escape by modifing the string
 void posix_sh_compress_inplace(char* str);
+// escape backslashes, tabs and newlines, such that the string can be
+// printed as one field of a tab-separated line
+std::string tab_field_escape(const std::string& source);
 
 
 /**
@@ -1,12 +1,16 @@
 #include "watchers.h"
 
+#include <algorithm>
+
 #include "argparse.h"
 #include "completion.h"
 #include "hook.h"
 #include "metacommands.h"
 #include "object.h"
+#include "utils.h"
 
 using std::string;
+using std::vector;
 
 Watchers::Watchers()
     : count_(this, "count", &Watchers::count)
@@ -21,15 +25,15 @@ void Watchers::injectDependencies(Object* root)
 
 void Watchers::scanForChanges()
 {
-    for (auto& it : lastValue_) {
-        Attribute* attr = root_->deepAttribute(it.first);
-        string newValue = "";
-        if (attr) {
-            newValue = attr->str();
+    for (auto& it : watched_) {
+        WatchedAttribute& watch = *it.second;
+        if (!watch.update()) {
+            continue;
         }
-        if (newValue != it.second) {
-            hook_emit({"attribute_changed", it.first, it.second, newValue});
-            it.second = newValue;
+        string newValue = watch.value();
+        if (newValue != watch.lastValue_) {
+            hook_emit({"attribute_changed", watch.path_, watch.lastValue_, newValue});
+            watch.lastValue_ = newValue;
         }
     }
 }
@@ -41,12 +45,12 @@ int Watchers::watchCommand(Input input, Output output)
     if (args.parsingAllFails(input, output)) {
         return args.exitCode();
     }
-    string value = "";
-    Attribute* attr = root_->deepAttribute(path);
-    if (attr) {
-        value = attr->str();
+    auto& watch = watched_[path];
+    if (!watch) {
+        watch = make_unique<WatchedAttribute>(*root_, path);
     }
-    lastValue_[path] = value;
+    watch->update();
+    watch->lastValue_ = watch->value();
     return 0;
 }
 
@@ -58,3 +62,123 @@ void Watchers::watchCompletion(Completion& complete)
         complete.none();
     }
 }
+
+Watchers::WatchedAttribute::WatchedAttribute(Object& root, const string& path)
+    : path_(path)
+    , root_(root)
+{
+    auto objectPathAndAttribute = Object::splitPath(path);
+    objectNames_ = objectPathAndAttribute.first.toVector();
+    attributeName_ = objectPathAndAttribute.second;
+}
+
+Watchers::WatchedAttribute::~WatchedAttribute()
+{
+    rehook({});
+}
+
+/*!
+ * Update the resolved path, if necessary.
+ * \return whether the attribute value might have changed since the
+ * last call
+ */
+bool Watchers::WatchedAttribute::update()
+{
+    if (dirty_ || dynamic_) {
+        bool dynamic = false;
+        vector<Object*> objects = resolvePath(dynamic);
+        dynamic_ = dynamic;
+        if (objects != hooked_) {
+            rehook(objects);
+            dirty_ = true;
+        }
+        Attribute* attribute = nullptr;
+        if (hooked_.size() == objectNames_.size() + 1) {
+            attribute = hooked_.back()->attribute(attributeName_);
+        }
+        if (attribute != attribute_) {
+            attribute_ = attribute;
+            dirty_ = true;
+        }
+    }
+    // attributes that are not hookable do not notify about changes
+    bool mightHaveChanged = dirty_ || (attribute_ && !attribute_->hookable());
+    dirty_ = false;
+    return mightHaveChanged;
+}
+
+//! the current value of the attribute or "" if it does not exist
+string Watchers::WatchedAttribute::value() const
+{
+    return attribute_ ? attribute_->str() : "";
+}
+
+//! the objects on the path, as far as they exist
+vector<Object*> Watchers::WatchedAttribute::resolvePath(bool& dynamic) const
+{
+    vector<Object*> objects = { &root_ };
+    for (const auto& name : objectNames_) {
+        Object* parent = objects.back();
+        if (parent->hasDynamicChild(name)) {
+            dynamic = true;
+        }
+        Object* child = parent->child(name);
+        if (!child) {
+            break;
+        }
+        objects.push_back(child);
+    }
+    return objects;
+}
+
+void Watchers::WatchedAttribute::rehook(const vector<Object*>& objects)
+{
+    for (Object* object : hooked_) {
+        object->removeHook(this);
+    }
+    hooked_ = objects;
+    for (Object* object : hooked_) {
+        object->addHook(this);
+    }
+}
+
+void Watchers::WatchedAttribute::childAdded(Object* parent, string childName)
+{
+    childChanged(parent, childName);
+}
+
+void Watchers::WatchedAttribute::childRemoved(Object* parent, string childName)
+{
+    childChanged(parent, childName);
+}
+
+//! mark the path as changed if the child is the next object on it
+void Watchers::WatchedAttribute::childChanged(Object* parent, const string& childName)
+{
+    for (size_t i = 0; i < hooked_.size() && i < objectNames_.size(); i++) {
+        if (hooked_[i] == parent && objectNames_[i] == childName) {
+            dirty_ = true;
+            return;
+        }
+    }
+}
+
+void Watchers::WatchedAttribute::attributeChanged(Object* sender, string attributeName)
+{
+    if (hooked_.size() == objectNames_.size() + 1
+        && hooked_.back() == sender
+        && attributeName == attributeName_)
+    {
+        dirty_ = true;
+    }
+}
+
+void Watchers::WatchedAttribute::objectDestroyed(Object* sender)
+{
+    // the object is gone, so we must not access it anymore,
+    // not even for removing our hook
+    hooked_.erase(std::remove(hooked_.begin(), hooked_.end(), sender),
+                  hooked_.end());
+    attribute_ = nullptr;
+    dirty_ = true;
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "attribute_.h"
 #include "converter.h"
+#include "hook.h"
 #include "object.h"
 
 class Completion;
@@ -20,7 +23,47 @@ public:
     int watchCommand(Input input, Output output);
     void watchCompletion(Completion& complete);
 private:
-    unsigned long count() const { return lastValue_.size(); }
+    /**
+     * A watched attribute. The path is resolved only once and the
+     * objects on the path are hooked, such that changes of the
+     * attribute value or of the path are pushed to the watch. Only if
+     * the path goes through a dynamic child (e.g. clients.focus) or the
+     * attribute does not notify about changes (e.g. a dynamic attribute)
+     * the path and the value are checked on every scan.
+     */
+    class WatchedAttribute : public Hook {
+    public:
+        WatchedAttribute(Object& root, const std::string& path);
+        ~WatchedAttribute() override;
+        void childAdded(Object* parent, std::string childName) override;
+        void childRemoved(Object* parent, std::string childName) override;
+        void attributeChanged(Object* sender, std::string attributeName) override;
+        void objectDestroyed(Object* sender) override;
+
+        bool update();
+        std::string value() const;
+
+        std::string path_;
+        std::string lastValue_;
+    private:
+        void childChanged(Object* parent, const std::string& childName);
+        std::vector<Object*> resolvePath(bool& dynamic) const;
+        void rehook(const std::vector<Object*>& objects);
+
+        Object& root_;
+        //! the object names on the path
+        std::vector<std::string> objectNames_;
+        std::string attributeName_;
+        //! the hooked objects on the path, starting at the root
+        std::vector<Object*> hooked_;
+        //! the watched attribute, if the entire path exists
+        Attribute* attribute_ = nullptr;
+        //! whether the path goes through a dynamic child
+        bool dynamic_ = false;
+        //! whether the path or the attribute value was changed since the last scan
+        bool dirty_ = true;
+    };
+    unsigned long count() const { return watched_.size(); }
     Object* root_ = nullptr;
-    std::map<std::string, std::string> lastValue_;
+    std::map<std::string, std::unique_ptr<WatchedAttribute>> watched_;
 };
@@ -0,0 +1,260 @@
+#include "windowproperties.h"
+
+#include <X11/Xatom.h>
+#ifdef WITH_XCB
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#endif
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "xconnection.h"
+
+using std::string;
+using std::vector;
+
+#ifdef WITH_XCB
+namespace {
+
+//! send a GetProperty request for the entire value of the given property
+xcb_get_property_cookie_t requestProperty(xcb_connection_t* c, Window window,
+                                          Atom property, Atom type)
+{
+    return xcb_get_property(c, 0, static_cast<xcb_window_t>(window),
+                            static_cast<xcb_atom_t>(property),
+                            static_cast<xcb_atom_t>(type),
+                            0, UINT32_MAX);
+}
+
+//! wait for the reply to the given GetProperty request. Errors (e.g. if
+//! the window was destroyed meanwhile) simply result in nullptr.
+xcb_get_property_reply_t* propertyReply(xcb_connection_t* c,
+                                        xcb_get_property_cookie_t cookie)
+{
+    xcb_generic_error_t* error = nullptr;
+    xcb_get_property_reply_t* reply = xcb_get_property_reply(c, cookie, &error);
+    free(error);
+    return reply;
+}
+
+//! the value of a property of format 32 and the given type,
+//! in the same way as XConnection::getWindowPropertyAtom() and friends
+template<typename T>
+std::experimental::optional<vector<T>>
+    property32(xcb_get_property_reply_t* reply, Atom type)
+{
+    if (!reply || reply->type != type || reply->format != 32) {
+        return {};
+    }
+    auto items = static_cast<uint32_t*>(xcb_get_property_value(reply));
+    int count = xcb_get_property_value_length(reply) / 4;
+    return vector<T>(items, items + count);
+}
+
+//! the value of a text property, in the same way as
+//! XConnection::getWindowProperty()
+std::experimental::optional<string>
+    textProperty(XConnection& X, xcb_get_property_reply_t* reply)
+{
+    if (!reply || reply->type == XCB_NONE) {
+        return {};
+    }
+    // the std::string guarantees null-termination of the value
+    string value(static_cast<char*>(xcb_get_property_value(reply)),
+                 xcb_get_property_value_length(reply));
+    XTextProperty prop;
+    prop.value = reinterpret_cast<unsigned char*>(&value[0]);
+    prop.encoding = reply->type;
+    prop.format = reply->format;
+    prop.nitems = value.size();
+    return X.textPropertyToString(prop);
+}
+
+//! decode WM_HINTS in the same way as XGetWMHints()
+std::experimental::optional<XWMHints> decodeWmHints(xcb_get_property_reply_t* reply)
+{
+    auto prop = property32<long>(reply, XA_WM_HINTS);
+    // the window group entry was added in ICCCM version 1
+    if (!prop.has_value() || prop.value().size() < 8) {
+        return {};
+    }
+    const vector<long>& v = prop.value();
+    XWMHints hints;
+    hints.flags = v[0];
+    hints.input = v[1] ? True : False;
+    hints.initial_state = static_cast<int>(v[2]);
+    hints.icon_pixmap = static_cast<Pixmap>(v[3]);
+    hints.icon_window = static_cast<Window>(v[4]);
+    hints.icon_x = static_cast<int>(v[5]);
+    hints.icon_y = static_cast<int>(v[6]);
+    hints.icon_mask = static_cast<Pixmap>(v[7]);
+    hints.window_group = v.size() >= 9 ? static_cast<XID>(v[8]) : 0;
+    return hints;
+}
+
+//! decode WM_NORMAL_HINTS in the same way as XGetWMNormalHints()
+std::experimental::optional<XSizeHints> decodeSizeHints(xcb_get_property_reply_t* reply)
+{
+    auto prop = property32<long>(reply, XA_WM_SIZE_HINTS);
+    // pre-ICCCM clients only set the first 15 entries
+    if (!prop.has_value() || prop.value().size() < 15) {
+        return {};
+    }
+    const vector<long>& v = prop.value();
+    XSizeHints hints;
+    memset(&hints, 0, sizeof(hints));
+    long supplied = USPosition | USSize | PAllHints;
+    hints.x = static_cast<int>(v[1]);
+    hints.y = static_cast<int>(v[2]);
+    hints.width = static_cast<int>(v[3]);
+    hints.height = static_cast<int>(v[4]);
+    hints.min_width = static_cast<int>(v[5]);
+    hints.min_height = static_cast<int>(v[6]);
+    hints.max_width = static_cast<int>(v[7]);
+    hints.max_height = static_cast<int>(v[8]);
+    hints.width_inc = static_cast<int>(v[9]);
+    hints.height_inc = static_cast<int>(v[10]);
+    hints.min_aspect.x = static_cast<int>(v[11]);
+    hints.min_aspect.y = static_cast<int>(v[12]);
+    hints.max_aspect.x = static_cast<int>(v[13]);
+    hints.max_aspect.y = static_cast<int>(v[14]);
+    if (v.size() >= 18) {
+        supplied |= PBaseSize | PWinGravity;
+        hints.base_width = static_cast<int>(v[15]);
+        hints.base_height = static_cast<int>(v[16]);
+        hints.win_gravity = static_cast<int>(v[17]);
+    }
+    hints.flags = v[0] & supplied;
+    return hints;
+}
+
+}
+
+WindowProperties WindowProperties::fetch(XConnection& X, Window window)
+{
+    xcb_connection_t* c = XGetXCBConnection(X.display());
+    xcb_window_t win = static_cast<xcb_window_t>(window);
+    // send all requests ...
+    auto geometryCookie = xcb_get_geometry(c, win);
+    auto pidCookie = requestProperty(c, window, X.atom("_NET_WM_PID"), XA_CARDINAL);
+    auto netWmNameCookie = requestProperty(c, window, X.atom("_NET_WM_NAME"), AnyPropertyType);
+    auto wmNameCookie = requestProperty(c, window, XA_WM_NAME, AnyPropertyType);
+    auto classCookie = requestProperty(c, window, XA_WM_CLASS, XA_STRING);
+    auto roleCookie = requestProperty(c, window, X.atom("WM_WINDOW_ROLE"), AnyPropertyType);
+    auto typeCookie = requestProperty(c, window, X.atom("_NET_WM_WINDOW_TYPE"), XA_ATOM);
+    auto stateCookie = requestProperty(c, window, X.atom("_NET_WM_STATE"), XA_ATOM);
+    auto transientCookie = requestProperty(c, window, XA_WM_TRANSIENT_FOR, XA_WINDOW);
+    auto wmHintsCookie = requestProperty(c, window, XA_WM_HINTS, XA_WM_HINTS);
+    auto sizeHintsCookie = requestProperty(c, window, XA_WM_NORMAL_HINTS, XA_WM_SIZE_HINTS);
+
+    // ... and only then collect the replies
+    WindowProperties props;
+    xcb_generic_error_t* error = nullptr;
+    auto geometry = xcb_get_geometry_reply(c, geometryCookie, &error);
+    free(error);
+    if (geometry) {
+        props.geometry = {
+            geometry->x, geometry->y, geometry->width, geometry->height
+        };
+        free(geometry);
+    }
+
+    auto reply = propertyReply(c, pidCookie);
+    auto pid = property32<long>(reply, XA_CARDINAL);
+    if (pid.has_value() && !pid.value().empty()) {
+        props.pid = static_cast<int>(pid.value()[0]);
+    }
+    free(reply);
+
+    reply = propertyReply(c, netWmNameCookie);
+    auto title = textProperty(X, reply);
+    free(reply);
+    reply = propertyReply(c, wmNameCookie);
+    if (!title.has_value()) {
+        title = textProperty(X, reply);
+    }
+    free(reply);
+    props.title = title.value_or("");
+
+    reply = propertyReply(c, classCookie);
+    if (reply && reply->type == XA_STRING && reply->format == 8) {
+        // WM_CLASS consists of two null-separated strings
+        const char* value = static_cast<char*>(xcb_get_property_value(reply));
+        size_t length = static_cast<size_t>(xcb_get_property_value_length(reply));
+        size_t nameLength = strnlen(value, length);
+        props.instance = string(value, nameLength);
+        if (nameLength < length) {
+            const char* classStart = value + nameLength + 1;
+            props.windowClass = string(classStart, strnlen(classStart, length - nameLength - 1));
+        }
+    }
+    free(reply);
+
+    reply = propertyReply(c, roleCookie);
+    props.windowRole = textProperty(X, reply);
+    free(reply);
+
+    reply = propertyReply(c, typeCookie);
+    props.windowType = property32<Atom>(reply, XA_ATOM).value_or(vector<Atom>());
+    free(reply);
+
+    reply = propertyReply(c, stateCookie);
+    props.windowState = property32<Atom>(reply, XA_ATOM).value_or(vector<Atom>());
+    free(reply);
+
+    reply = propertyReply(c, transientCookie);
+    auto transientFor = property32<Window>(reply, XA_WINDOW);
+    if (transientFor.has_value() && !transientFor.value().empty()) {
+        props.transientFor = transientFor.value()[0];
+    }
+    free(reply);
+
+    reply = propertyReply(c, wmHintsCookie);
+    props.wmHints = decodeWmHints(reply);
+    free(reply);
+
+    reply = propertyReply(c, sizeHintsCookie);
+    props.sizeHints = decodeSizeHints(reply);
+    free(reply);
+    return props;
+}
+
+#else // WITH_XCB
+
+/* Without xcb, Xlib offers no way to pipeline the requests, so the
+ * properties are queried one at a time.
+ */
+WindowProperties WindowProperties::fetch(XConnection& X, Window window)
+{
+    WindowProperties props;
+    props.geometry = X.windowSize(window);
+    props.pid = X.windowPid(window);
+    auto title = X.getWindowProperty(window, X.atom("_NET_WM_NAME"));
+    if (!title.has_value()) {
+        title = X.getWindowProperty(window, XA_WM_NAME);
+    }
+    props.title = title.value_or("");
+    auto classHint = X.getClassHint(window);
+    props.instance = classHint.first;
+    props.windowClass = classHint.second;
+    props.windowRole = X.getWindowProperty(window, X.atom("WM_WINDOW_ROLE"));
+    props.windowType = X.getWindowPropertyAtom(window, X.atom("_NET_WM_WINDOW_TYPE"))
+                       .value_or(vector<Atom>());
+    props.windowState = X.getWindowPropertyAtom(window, X.atom("_NET_WM_STATE"))
+                        .value_or(vector<Atom>());
+    props.transientFor = X.getTransientForHint(window);
+    XWMHints* wmHints = XGetWMHints(X.display(), window);
+    if (wmHints) {
+        props.wmHints = *wmHints;
+        XFree(wmHints);
+    }
+    XSizeHints sizeHints;
+    long supplied;
+    if (XGetWMNormalHints(X.display(), window, &sizeHints, &supplied)) {
+        props.sizeHints = sizeHints;
+    }
+    return props;
+}
+
+#endif // WITH_XCB
@@ -0,0 +1,39 @@
+#ifndef __HLWM_WINDOWPROPERTIES_H_
+#define __HLWM_WINDOWPROPERTIES_H_
+
+#include <X11/X.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <string>
+#include <vector>
+
+#include "optional.h"
+#include "rectangle.h"
+
+class XConnection;
+
+/**
+ * A snapshot of all window properties that are read when a window
+ * gets managed: by the client construction, the default rules and the
+ * rule conditions. fetch() sends all requests at once and only then
+ * collects the replies, so creating a snapshot costs a single round
+ * trip to the X server instead of one round trip per property.
+ */
+class WindowProperties {
+public:
+    static WindowProperties fetch(XConnection& X, Window window);
+
+    Rectangle geometry = {0, 0, 0, 0};
+    int pid = -1; // -1 if _NET_WM_PID is not set
+    std::string title; // _NET_WM_NAME or otherwise WM_NAME
+    std::string instance; // first entry of WM_CLASS
+    std::string windowClass; // second entry of WM_CLASS
+    std::experimental::optional<std::string> windowRole;
+    std::vector<Atom> windowType;
+    std::vector<Atom> windowState;
+    std::experimental::optional<Window> transientFor;
+    std::experimental::optional<XWMHints> wmHints;
+    std::experimental::optional<XSizeHints> sizeHints;
+};
+
+#endif
@@ -31,7 +31,16 @@ XConnection::XConnection(Display* disp)
     m_screen_width = DisplayWidth(m_display, m_screen);
     m_screen_height = DisplayHeight(m_display, m_screen);
     m_root = RootWindow(m_display, m_screen);
-    utf8StringAtom_ = XInternAtom(m_display, "UTF8_STRING", False);
+    // intern the atoms used on hot paths at once, such that
+    // later calls to atom() do not need a round trip
+    internAtoms({
+        "UTF8_STRING",
+        "WM_WINDOW_ROLE",
+        "_NET_WM_PID",
+        "_NET_WM_STRUT",
+        "_NET_WM_STRUT_PARTIAL",
+    });
+    utf8StringAtom_ = atom("UTF8_STRING");
     visual_ = DefaultVisual(m_display, m_screen);
     depth_ = DefaultDepth(m_display, m_screen);
     colormap_ = DefaultColormap(m_display, m_screen);
@@ -175,8 +184,36 @@ Rectangle XConnection::windowSize(Window window) {
     return { x, y, (int)w, (int)h };
 }
 
+//! the atom for the given name. Only the first call for a name
+//! causes a round trip to the server
 Atom XConnection::atom(const char* atom_name) {
-    return XInternAtom(m_display, atom_name, False);
+    auto it = atomCache_.find(atom_name);
+    if (it != atomCache_.end()) {
+        return it->second;
+    }
+    atomCacheMisses_++;
+    Atom atom = XInternAtom(m_display, atom_name, False);
+    atomCache_[atom_name] = atom;
+    return atom;
+}
+
+//! intern all given atoms (that are not cached yet) in a single round trip
+void XConnection::internAtoms(const vector<string>& atomNames) {
+    vector<char*> missing;
+    for (const auto& name : atomNames) {
+        if (atomCache_.find(name) == atomCache_.end()) {
+            missing.push_back(const_cast<char*>(name.c_str()));
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+    vector<Atom> atoms(missing.size(), None);
+    XInternAtoms(m_display, missing.data(), static_cast<int>(missing.size()),
+                 False, atoms.data());
+    for (size_t i = 0; i < missing.size(); i++) {
+        atomCache_[missing[i]] = atoms[i];
+    }
 }
 
 
@@ -243,15 +280,22 @@ static string iso_8859_1_to_utf8(const char* source) {
 }
 
 std::experimental::optional<string> XConnection::getWindowProperty(Window window, Atom atom) {
-    string result;
-    char** list = nullptr;
-    int n = 0;
     XTextProperty prop;
 
     if (0 == XGetTextProperty(m_display, window, &prop, atom)) {
         return std::experimental::optional<string>();
     }
-    // convert text property to a gstring
+    string result = textPropertyToString(prop);
+    XFree(prop.value);
+    return result;
+}
+
+//! convert the value of a text property to an utf8 string. The value must
+//! be null-terminated.
+string XConnection::textPropertyToString(XTextProperty& prop) {
+    string result;
+    char** list = nullptr;
+    int n = 0;
     if (prop.encoding == XA_STRING) {
         // a XA_STRING is always encoded in ISO 8859-1
         result = iso_8859_1_to_utf8(reinterpret_cast<char *>(prop.value));
@@ -265,7 +309,6 @@ std::experimental::optional<string> XConnection::getWindowProperty(Window window
             XFreeStringList(list);
         }
     }
-    XFree(prop.value);
     return result;
 }
 
@@ -3,7 +3,10 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <X11/Xutil.h>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "optional.h"
 #include "rectangle.h"
@@ -36,11 +39,15 @@ public:
     int windowPid(Window window);
     int windowPgid(Window window);
     Atom atom(const char* atom_name);
+    void internAtoms(const std::vector<std::string>& atomNames);
+    //! the number of atom() calls that required a round trip to the server
+    unsigned long atomCacheMisses() const { return atomCacheMisses_; }
     std::string atomName(Atom atomIdentifier);
     std::pair<std::string, std::string> getClassHint(Window win);
     std::string getInstance(Window win) { return getClassHint(win).first; };
     std::string getClass(Window win) { return getClassHint(win).second; };
     std::experimental::optional<std::string> getWindowProperty(Window window, Atom atom);
+    std::string textPropertyToString(XTextProperty& prop);
     std::experimental::optional<std::vector<long>>
         getWindowPropertyCardinal(Window window, Atom property);
     std::experimental::optional<std::vector<Atom>>
@@ -64,6 +71,8 @@ private:
     int      m_screen_width;
     int      m_screen_height;
     Atom     utf8StringAtom_;
+    std::unordered_map<std::string, Atom> atomCache_;
+    unsigned long atomCacheMisses_ = 0;
     int depth_;
     Visual* visual_;
     Colormap colormap_;
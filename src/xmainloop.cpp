@@ -3,8 +3,12 @@
 #include <X11/X.h>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
+#include <sys/select.h>
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "client.h"
 #include "clientmanager.h"
@@ -32,6 +36,8 @@
 
 using std::function;
 using std::shared_ptr;
+using std::string;
+using std::vector;
 
 /** A custom event handler casting function.
  *
@@ -160,16 +166,56 @@ void XMainLoop::run() {
     XEvent event;
     int x11_fd;
     fd_set in_fds;
+    fd_set out_fds;
     x11_fd = ConnectionNumber(X_.display());
     while (!aboutToQuit_) {
+        // the event handlers only mark monitors as dirty. So after the
+        // entire batch of events is processed, every dirty monitor is
+        // relayouted exactly once
+        root_->monitors->applyDirtyLayouts();
+        root_->watchers->scanForChanges();
+        // XPending() flushes all requests of the previous batch in one go
+        // and reads the events that already arrived, both without waiting
+        // for a round trip to the server.
+        bool eventsPending = XPending(X_.display()) > 0;
         FD_ZERO(&in_fds);
+        FD_ZERO(&out_fds);
         FD_SET(x11_fd, &in_fds);
-        // wait for an event or a signal
-        select(x11_fd + 1, &in_fds, nullptr, nullptr, nullptr);
+        int maxFd = std::max(x11_fd, root_->ipcServer_.fillFdSets(&in_fds, &out_fds));
+        // wait for an event, an ipc request, a signal or the next timer
+        // (e.g. the timeout of the key mode). If there are X events
+        // already, only poll the ipc sockets, such that they are not
+        // starved by a flood of X events.
+        struct timeval timeout;
+        struct timeval* timeoutPtr = nullptr;
+        auto waitTime = root_->timers.timeUntilNext();
+        if (eventsPending) {
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 0;
+            timeoutPtr = &timeout;
+        } else if (waitTime.has_value()) {
+            long milliseconds = waitTime.value().count();
+            timeout.tv_sec = milliseconds / 1000;
+            timeout.tv_usec = (milliseconds % 1000) * 1000;
+            timeoutPtr = &timeout;
+        }
+        int ready = select(maxFd + 1, &in_fds, &out_fds, nullptr, timeoutPtr);
         if (aboutToQuit_) {
             break;
         }
-        XSync(X_.display(), False);
+        root_->timers.runExpired();
+        if (ready > 0) {
+            root_->ipcServer_.handleFdSets(&in_fds, &out_fds,
+                [this](const vector<string>& call) {
+                    auto result = HlwmCommon::callCommand(call);
+                    root_->watchers->scanForChanges();
+                    return result;
+                });
+        }
+        if (!eventsPending) {
+            // read the new events into the event queue
+            XPending(X_.display());
+        }
         while (XQLength(X_.display())) {
             XNextEvent(X_.display(), &event);
             EventHandler handler = handlerTable_[event.type];
@@ -177,7 +223,6 @@ void XMainLoop::run() {
                 (this ->* handler)(&event);
             }
             root_->watchers->scanForChanges();
-            XSync(X_.display(), False);
         }
     }
 }
@@ -518,6 +563,16 @@ void XMainLoop::selectionclear(XSelectionClearEvent* event)
 void XMainLoop::propertynotify(XPropertyEvent* ev) {
     // printf("name is: PropertyNotify\n");
     Client* client = root_->clients->client(ev->window);
+    if (client != nullptr) {
+        // keep the cached properties up to date, also if they are deleted
+        if (ev->atom == XA_WM_CLASS) {
+            client->update_class();
+        } else if (ev->atom == X_.atom("WM_WINDOW_ROLE")) {
+            client->update_window_role();
+        } else if (ev->atom == root_->ewmh_.netatom(NetWmWindowType)) {
+            client->update_window_type();
+        }
+    }
     if (ev->state == PropertyNewValue) {
         if (root_->ipcServer_.isConnectable(ev->window)) {
             root_->ipcServer_.handleConnection(ev->window,
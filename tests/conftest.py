@@ -9,8 +9,10 @@ import re
 import select
 import selectors
 import shlex
+import shutil
 import subprocess
 import sys
+import tempfile
 import textwrap
 import time
 import types
@@ -42,13 +44,18 @@ class HlwmBridge(herbstluftwm.Herbstluftwm):
     INSTANCE = None
 
     def __init__(self, display, hlwm_process):
-        herbstluftwm.Herbstluftwm.__init__(self, herbstclient=self.HC_PATH)
+        # if hlwm listens on the unix socket, then all commands are sent
+        # over a single connection instead of running herbstclient
+        herbstluftwm.Herbstluftwm.__init__(self, herbstclient=self.HC_PATH,
+                                           persistent=True)
         HlwmBridge.INSTANCE = self
         self.client_procs = []
         self.next_client_id = 0
         self.env = {
             'DISPLAY': display,
         }
+        if 'XDG_RUNTIME_DIR' in hlwm_process.env:
+            self.env['XDG_RUNTIME_DIR'] = hlwm_process.env['XDG_RUNTIME_DIR']
         self.env = extend_env_with_whitelist(self.env)
         self.hlwm_process = hlwm_process
         self.hc_idle = subprocess.Popen(
@@ -71,6 +78,28 @@ class HlwmBridge(herbstluftwm.Herbstluftwm):
         except subprocess.TimeoutExpired:
             self.hlwm_process.investigate_timeout('calling ' + str(args))
 
+        self._log_call(args, proc, log_output)
+
+        # Take this opportunity read and echo any hlwm output captured in the
+        # meantime:
+        if read_hlwm_output:
+            self.hlwm_process.read_and_echo_output()
+
+        return proc
+
+    def unchecked_call_many(self, cmds):
+        """call the commands but do not check exit codes or stderr"""
+        try:
+            procs = herbstluftwm.Herbstluftwm.unchecked_call_many(self, cmds)
+        except subprocess.TimeoutExpired:
+            self.hlwm_process.investigate_timeout('calling ' + str(cmds))
+
+        for proc in procs:
+            self._log_call(proc.args, proc, True)
+        self.hlwm_process.read_and_echo_output()
+        return procs
+
+    def _log_call(self, args, proc, log_output):
         outcome = 'succeeded' if proc.returncode == 0 else 'failed'
         allout = proc.stdout + proc.stderr
         if allout:
@@ -82,13 +111,6 @@ class HlwmBridge(herbstluftwm.Herbstluftwm):
         else:
             print(f'Client command {args} {outcome} (no output)')
 
-        # Take this opportunity read and echo any hlwm output captured in the
-        # meantime:
-        if read_hlwm_output:
-            self.hlwm_process.read_and_echo_output()
-
-        return proc
-
     def call_xfail(self, cmd):
         """ Call the command, expect it to terminate with a non-zero exit code,
         emit no output on stdout but some output on stderr. The returned
@@ -262,6 +284,7 @@ class HlwmBridge(herbstluftwm.Herbstluftwm):
         for client_proc in self.client_procs:
             client_proc.terminate()
         self.hc_idle.terminate()
+        self.disconnect()
 
         # and then wait for each of them to finish:
         for client_proc in self.client_procs:
@@ -294,6 +317,7 @@ class HlwmProcess:
         - args is a list of additional command line arguments
         """
         self.bin_path = os.path.join(BINDIR, 'herbstluftwm')
+        self.env = env
         self.proc = subprocess.Popen(
             [self.bin_path, '--exit-on-xerror', '--verbose'] + args, env=env,
             bufsize=0,  # essential for reading output with selectors!
@@ -513,13 +537,14 @@ def hlwm_spawner(tmpdir):
     """yield a function to spawn hlwm"""
     assert xvfb is not None, 'Refusing to run tests in a non-Xvfb environment (possibly your actual X server?)'
 
-    def spawn(args=[], display=None):
+    def spawn(args=[], display=None, extra_env={}):
         if display is None:
             display = os.environ['DISPLAY']
         env = {
             'DISPLAY': display,
             'XDG_CONFIG_HOME': str(tmpdir),
         }
+        env.update(extra_env)
         env = extend_env_with_whitelist(env)
         autostart = tmpdir / 'herbstluftwm' / 'autostart'
         autostart.ensure()
@@ -532,6 +557,15 @@ def hlwm_spawner(tmpdir):
     return spawn
 
 
+@pytest.fixture()
+def xdg_runtime_dir():
+    """yield a directory for XDG_RUNTIME_DIR. In contrast to tmpdir, its
+    path is short enough for the unix socket in it"""
+    directory = tempfile.mkdtemp(prefix='hlwm-')
+    yield directory
+    shutil.rmtree(directory)
+
+
 @pytest.fixture()
 def xvfb(request):
     # start an Xvfb server (don't start Xephyr because
@@ -564,6 +598,8 @@ def xvfb(request):
 def hlwm_process(hlwm_spawner, request, xvfb):
     parameters = {
         'transparency': True,
+        # whether hlwm listens on the unix socket
+        'socket': False,
     }
     if hasattr(request, 'param'):
         # the param must contain a dictionary possibly
@@ -574,7 +610,11 @@ def hlwm_process(hlwm_spawner, request, xvfb):
     additional_commandline = ['--no-tag-import']
     if not parameters['transparency']:
         additional_commandline += ['--no-transparency']
-    hlwm_proc = hlwm_spawner(additional_commandline, display=xvfb.display)
+    extra_env = {}
+    if parameters['socket']:
+        extra_env['XDG_RUNTIME_DIR'] = request.getfixturevalue('xdg_runtime_dir')
+    hlwm_proc = hlwm_spawner(additional_commandline, display=xvfb.display,
+                             extra_env=extra_env)
 
     yield hlwm_proc
 
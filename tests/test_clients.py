@@ -1,4 +1,5 @@
 import pytest
+from Xlib import Xatom
 from herbstluftwm.types import Rectangle
 
 
@@ -189,6 +190,40 @@ def test_client_wm_class_none(hlwm, x11):
     assert hlwm.get_attr('clients.{}.class'.format(winid)) == ''
 
 
+def test_client_window_role_and_type_follow_property_changes(hlwm, x11):
+    handle, winid = x11.create_client(window_type='_NET_WM_WINDOW_TYPE_UTILITY')
+    assert hlwm.get_attr(f'clients.{winid}.windowrole') == ''
+    assert hlwm.get_attr(f'clients.{winid}.windowtype') == '_NET_WM_WINDOW_TYPE_UTILITY'
+
+    handle.change_property(x11.display.intern_atom('WM_WINDOW_ROLE'),
+                           Xatom.STRING, 8, b'myrole')
+    handle.delete_property(x11.display.intern_atom('_NET_WM_WINDOW_TYPE'))
+    x11.sync_with_hlwm()
+
+    assert hlwm.get_attr(f'clients.{winid}.windowrole') == 'myrole'
+    assert hlwm.get_attr(f'clients.{winid}.windowtype') == ''
+    hlwm.call('rule once windowrole=myrole tag=othertag')
+    hlwm.call('add othertag')
+    hlwm.call(['apply_rules', winid])
+    assert hlwm.get_attr(f'clients.{winid}.tag') == 'othertag'
+
+
+@pytest.mark.parametrize("role", [None, b'', b'myrole'])
+def test_windowrole_condition_distinguishes_empty_and_unset_role(hlwm, x11, role):
+    def set_role(win):
+        if role is not None:
+            win.change_property(x11.display.intern_atom('WM_WINDOW_ROLE'),
+                                Xatom.STRING, 8, role)
+    hlwm.call('rule once windowrole= tag=othertag')
+    hlwm.call('add othertag')
+
+    _, winid = x11.create_client(pre_map=set_role)
+
+    assert hlwm.get_attr(f'clients.{winid}.windowrole') == (role or b'').decode()
+    expected_tag = 'othertag' if role == b'' else 'default'
+    assert hlwm.get_attr(f'clients.{winid}.tag') == expected_tag
+
+
 def test_bring_from_different_tag(hlwm, x11):
     _, bonnie = x11.create_client()
     hlwm.call('true')
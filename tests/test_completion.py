@@ -9,7 +9,6 @@ commands_without_input = shlex.split(
     close_or_remove
     false
     list_commands
-    list_keybinds
     list_monitors
     list_rules
     lock
@@ -65,6 +65,25 @@ def test_window_border_outer(hlwm, x11):
             assert img.pixel(x, y) == expected_color
 
 
+def test_window_border_follows_focus(hlwm, x11):
+    active_color = (239, 2, 190)
+    normal_color = (48, 225, 26)
+    hlwm.attr.theme.border_width = 3
+    hlwm.attr.theme.active.color = RawImage.rgb2string(active_color)
+    hlwm.attr.theme.normal.color = RawImage.rgb2string(normal_color)
+    hlwm.call('split explode')
+    handle1, winid1 = x11.create_client()
+    handle2, winid2 = x11.create_client()
+
+    for focused, unfocused in [(winid1, winid2), (winid2, winid1)]:
+        hlwm.call(['jumpto', focused])
+        x11.sync_with_hlwm()
+        img_focused = x11.decoration_screenshot(x11.window(focused))
+        img_unfocused = x11.decoration_screenshot(x11.window(unfocused))
+        assert img_focused.pixel(0, 0) == active_color
+        assert img_unfocused.pixel(0, 0) == normal_color
+
+
 def screenshot_with_title(x11, win_handle, title):
     """ set the win_handle's window title and then
     take a screenshot
@@ -57,6 +57,7 @@ def create_panel(hlwm):
 # map every c++ class name to a function ("constructor") accepting an hlwm
 # fixture and returning the path to an example object of the C++ class
 classname2examplepath = [
+    ('AttributeJournal', lambda _: 'journal'),
     ('ByName', lambda _: 'monitors.by-name'),
     ('Client', create_client),
     ('ClientManager', create_clients_with_all_links),
@@ -70,6 +71,7 @@ classname2examplepath = [
     ('Panel', create_panel),
     ('Root', lambda _: ''),
     ('Settings', lambda _: 'settings'),
+    ('Statistics', lambda _: 'stats'),
     ('TagManager', lambda _: 'tags'),
     ('Theme', lambda _: 'theme'),
     ('TypesDoc', lambda _: 'types'),
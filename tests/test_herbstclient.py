@@ -1,9 +1,14 @@
+import ctypes
 import subprocess
 import os
 import re
+import select
+import socket
+import struct
 import pytest
 
 HC_PATH = os.path.join(os.path.abspath(os.environ['PWD']), 'herbstclient')
+LIBHC_PATH = os.path.join(os.path.abspath(os.environ['PWD']), 'libherbstclient.so')
 
 
 @pytest.mark.parametrize('argument', ['version', '--idle'])
@@ -220,3 +225,526 @@ def test_ensure_newline(hlwm):
                            universal_newlines=True)
     assert proc1.stdout == "test\n"
     assert proc2.stdout == "test\n"
+
+
+def socket_path(runtime_dir):
+    display = os.environ['DISPLAY']
+    if '.' in display[display.rfind(':'):]:
+        display = display[:display.rfind('.')]
+    return os.path.join(runtime_dir, 'herbstluftwm',
+                        'socket' + display.replace('/', '_'))
+
+
+def socket_request(sock, args):
+    message = b''.join(arg.encode() + b'\0' for arg in args)
+    sock.sendall(struct.pack('!I', len(message)) + message)
+
+
+def recv_exactly(sock, size):
+    data = b''
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        assert chunk, 'connection closed unexpectedly'
+        data += chunk
+    return data
+
+
+def socket_reply(sock):
+    length, = struct.unpack('!I', recv_exactly(sock, 4))
+    status, = struct.unpack('!i', recv_exactly(sock, 4))
+    return status, recv_exactly(sock, length - 4).decode()
+
+
+@pytest.fixture()
+def hlwm_socket_process(hlwm_spawner, xdg_runtime_dir):
+    """spawn hlwm listening on the unix socket"""
+    hlwm_proc = hlwm_spawner(extra_env={'XDG_RUNTIME_DIR': xdg_runtime_dir})
+    yield hlwm_proc
+    hlwm_proc.shutdown()
+
+
+@pytest.fixture()
+def hlwm_with_socket(hlwm_socket_process, xdg_runtime_dir):
+    """spawn hlwm listening on the unix socket and return an environment
+    for herbstclient that uses the socket"""
+    env = dict(os.environ)
+    env['XDG_RUNTIME_DIR'] = xdg_runtime_dir
+    return env
+
+
+@pytest.fixture()
+def socket_connection(hlwm_with_socket, xdg_runtime_dir):
+    """yield a socket that is connected to hlwm"""
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(socket_path(xdg_runtime_dir))
+    yield sock
+    sock.close()
+
+
+def test_socket_is_created_and_removed(hlwm_socket_process, xdg_runtime_dir):
+    path = socket_path(xdg_runtime_dir)
+    assert os.path.exists(path)
+    assert os.stat(os.path.dirname(path)).st_mode & 0o777 == 0o700
+
+    hlwm_socket_process.shutdown()
+
+    assert not os.path.exists(path)
+
+
+def test_stale_socket_is_replaced(hlwm_spawner, xdg_runtime_dir):
+    path = socket_path(xdg_runtime_dir)
+    os.mkdir(os.path.dirname(path), 0o700)
+    # a socket that nobody listens on, as left behind by a crash
+    stale = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    stale.bind(path)
+    stale.close()
+
+    hlwm_proc = hlwm_spawner(extra_env={'XDG_RUNTIME_DIR': xdg_runtime_dir})
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(path)
+    socket_request(sock, ['echo', 'replaced'])
+    assert socket_reply(sock) == (0, 'replaced\n')
+    sock.close()
+    hlwm_proc.shutdown()
+
+
+def test_herbstclient_via_socket(hlwm_socket_process, hlwm_with_socket):
+    env = hlwm_with_socket
+    proc = subprocess.run([HC_PATH, 'echo', 'via', 'socket'],
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                          env=env, universal_newlines=True)
+    assert proc.returncode == 0
+    assert proc.stdout == 'via socket\n'
+    assert proc.stderr == ''
+
+    # errors are reported on stderr with the exit status of the command
+    proc = subprocess.run([HC_PATH, 'get_attr', 'does_not_exist'],
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                          env=env, universal_newlines=True)
+    assert proc.returncode != 0
+    assert proc.stdout == ''
+    assert 'does_not_exist' in proc.stderr
+
+    # if hlwm is gone, then herbstclient falls back to the X transport
+    hlwm_socket_process.shutdown()
+    proc = subprocess.run([HC_PATH, '--quiet', 'echo', 'x'],
+                          stdout=subprocess.PIPE, env=env)
+    assert proc.returncode != 0
+
+
+def test_socket_connection_carries_many_requests(socket_connection):
+    sock = socket_connection
+
+    # send all requests before reading the first reply
+    socket_request(sock, ['new_attr', 'int', 'my_counter', '5'])
+    for _ in range(0, 10):
+        socket_request(sock, ['attr', 'my_counter', '+=1'])
+    socket_request(sock, ['get_attr', 'my_counter'])
+    socket_request(sock, ['get_attr', 'my_does_not_exist'])
+    socket_request(sock, ['echo', 'with spaces', '', 'x'])
+
+    assert socket_reply(sock) == (0, '')
+    for _ in range(0, 10):
+        assert socket_reply(sock) == (0, '')
+    assert socket_reply(sock) == (0, '15')
+    status, output = socket_reply(sock)
+    assert status != 0
+    assert socket_reply(sock) == (0, 'with spaces  x\n')
+
+    # the replies are still sent after the client closed its sending side
+    socket_request(sock, ['get_attr', 'my_counter'])
+    sock.shutdown(socket.SHUT_WR)
+    assert socket_reply(sock) == (0, '15')
+
+
+def test_socket_drops_client_not_reading_replies(hlwm_with_socket, socket_connection):
+    sock = socket_connection
+    long_arg = 1000 * 'x'
+    # the replies are much larger than the limit on the unread replies
+    requests = 4000
+    try:
+        for _ in range(0, requests):
+            socket_request(sock, ['echo', long_arg])
+    except (BrokenPipeError, ConnectionResetError):
+        pass
+
+    replies = 0
+    try:
+        while socket_reply(sock) == (0, long_arg + '\n'):
+            replies += 1
+    except (AssertionError, ConnectionResetError):
+        # the connection was closed
+        pass
+    assert replies < requests
+    sock.close()
+    # hlwm still serves other clients
+    assert hc_output(hlwm_with_socket, ['echo', 'alive']) == 'alive\n'
+
+
+def run_batch(batch, args=[], env=None):
+    return subprocess.run([HC_PATH, '--batch'] + args,
+                          input=batch,
+                          stdout=subprocess.PIPE,
+                          stderr=subprocess.PIPE,
+                          env=env,
+                          universal_newlines=True)
+
+
+def test_batch_via_x(hlwm):
+    batch = '\n'.join([
+        'new_attr string my_str',
+        '# a comment and an empty line',
+        '',
+        'set_attr my_str "with \\"quotes\\"" ',
+        "echo 'single  quoted' back\\ slash",
+        'get_attr my_str',
+    ])
+    proc = run_batch(batch)
+
+    assert proc.stderr == ''
+    assert proc.stdout == 'single  quoted back slash\nwith "quotes"\n'
+    assert proc.returncode == 0
+
+
+def test_batch_via_socket(hlwm_with_socket):
+    batch = 'new_attr int my_int 0\n'
+    batch += 100 * 'attr my_int +=1\n'
+    batch += 'get_attr my_int\n'
+
+    proc = run_batch(batch, env=hlwm_with_socket)
+
+    assert proc.stderr == ''
+    assert proc.stdout == '100\n'
+    assert proc.returncode == 0
+
+
+def test_batch_via_socket_with_large_replies(hlwm_with_socket):
+    # the replies of the whole batch exceed the limit on the unread replies
+    long_arg = 1000 * 'x'
+    batch = 4000 * f'echo {long_arg}\n'
+
+    proc = run_batch(batch, env=hlwm_with_socket)
+
+    assert proc.stderr == ''
+    assert proc.stdout == 4000 * f'{long_arg}\n'
+    assert proc.returncode == 0
+
+
+def test_batch_failing_commands(hlwm):
+    batch = 'echo first\nget_attr does_not_exist\necho second\nfoobar\n'
+    proc = run_batch(batch)
+
+    # the remaining commands are still executed
+    assert proc.stdout == 'first\nsecond\n'
+    assert re.search(r'-:2: get_attr returned 3', proc.stderr)
+    assert re.search(r'-:4: foobar returned 2', proc.stderr)
+    assert proc.returncode == 3
+
+
+def test_batch_print0(hlwm):
+    proc = run_batch('echo a\0echo b\nc\0get_attr tags.count\0', args=['-0'])
+
+    assert proc.stdout == 'a\n\0b c\n\0' + '1\0'
+    assert proc.returncode == 0
+
+
+def test_batch_from_files(hlwm, tmpdir):
+    first = tmpdir / 'first'
+    first.write('echo 1\necho 2\n')
+    second = tmpdir / 'second'
+    second.write('echo 3\n')
+
+    proc = run_batch('echo stdin\n', args=[str(first), '-', str(second)])
+
+    assert proc.stdout == '1\n2\nstdin\n3\n'
+    assert proc.returncode == 0
+
+
+def test_batch_unmatched_quote(hlwm):
+    proc = run_batch('new_attr bool my_bool\necho "unmatched\n')
+
+    assert re.search(r'-:2: unmatched quote', proc.stderr)
+    assert proc.returncode != 0
+    # nothing has been executed
+    hlwm.call_xfail('get_attr my_bool')
+
+
+def socket_hook(sock):
+    length, = struct.unpack('!I', recv_exactly(sock, 4))
+    sequence, = struct.unpack('!Q', recv_exactly(sock, 8))
+    args = recv_exactly(sock, length - 8).decode().split('\0')[:-1]
+    return sequence, args
+
+
+def hc_output(env, args):
+    return subprocess.run([HC_PATH] + args, stdout=subprocess.PIPE,
+                          env=env, universal_newlines=True,
+                          check=True).stdout
+
+
+def test_hook_stream_sequence_numbers(hlwm_with_socket, socket_connection):
+    sock = socket_connection
+    socket_request(sock, ['', 'subscribe', ''])
+    status, next_sequence = socket_reply(sock)
+    assert status == 0
+
+    run_batch(''.join(f'emit_hook myhook {i}\n' for i in range(0, 20)),
+              env=hlwm_with_socket)
+
+    for i in range(0, 20):
+        assert socket_hook(sock) == (int(next_sequence) + i, ['myhook', str(i)])
+    emitted = hc_output(hlwm_with_socket, ['get_attr', 'stats.hooks_emitted'])
+    assert int(emitted) == int(next_sequence) + 19
+    delivered = hc_output(hlwm_with_socket, ['get_attr', 'stats.hooks_delivered'])
+    assert int(delivered) >= 20
+
+
+def test_hook_stream_control_request_errors(socket_connection):
+    sock = socket_connection
+    socket_request(sock, ['', 'unknown'])
+    socket_request(sock, ['', 'subscribe', 'x'])
+    socket_request(sock, ['', 'subscribe', '', '(unmatched'])
+    socket_request(sock, ['echo', 'still working'])
+
+    assert socket_reply(sock) == (3, 'Unknown control request\n')
+    assert socket_reply(sock) == (3, 'Invalid sequence number "x"\n')
+    status, output = socket_reply(sock)
+    assert status == 3
+    assert output.startswith('Cannot parse regex "(unmatched"')
+    assert socket_reply(sock) == (0, 'still working\n')
+
+
+def test_herbstclient_resume_hooks(hlwm_with_socket):
+    env = hlwm_with_socket
+    first = int(hc_output(env, ['get_attr', 'stats.hooks_emitted'])) + 1
+    run_batch('emit_hook myhook a\nemit_hook other\nemit_hook myhook b\n', env=env)
+
+    # the hooks were emitted before herbstclient was started
+    output = hc_output(env, ['--wait', '--count', '2', '--sequence',
+                             '--resume', str(first), 'myhook'])
+
+    assert output.splitlines() == [
+        f'{first}\tmyhook\ta',
+        f'{first + 2}\tmyhook\tb',
+    ]
+
+
+def test_herbstclient_resume_reports_lost_hooks(hlwm_with_socket):
+    env = hlwm_with_socket
+    first = int(hc_output(env, ['get_attr', 'stats.hooks_emitted'])) + 1
+    # the backlog only holds the 1000 most recent hooks
+    run_batch(''.join(f'emit_hook myhook {i}\n' for i in range(0, 1010)), env=env)
+    dropped_before = int(hc_output(env, ['get_attr', 'stats.hooks_dropped']))
+
+    proc = subprocess.run([HC_PATH, '--wait', '--sequence',
+                           '--resume', str(first)],
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                          env=env, universal_newlines=True)
+
+    assert proc.stdout == f'{first + 10}\tmyhook\t10\n'
+    assert proc.stderr == 'Warning: missed 10 hooks\n'
+    dropped = int(hc_output(env, ['get_attr', 'stats.hooks_dropped']))
+    assert dropped == dropped_before + 10
+
+
+def test_herbstclient_sequence_requires_socket(hlwm):
+    proc = subprocess.run([HC_PATH, '--idle', '--sequence'],
+                          stderr=subprocess.PIPE, universal_newlines=True)
+
+    assert proc.returncode != 0
+    assert 'unix socket' in proc.stderr
+
+
+def test_hook_stream_filter(hlwm_with_socket, socket_connection):
+    env = hlwm_with_socket
+    sock = socket_connection
+    # the filters match anywhere in the hook name and the first argument
+    socket_request(sock, ['', 'subscribe', '', 'title', '^0x'])
+    status, next_sequence = socket_reply(sock)
+    assert status == 0
+    delivered_before = int(hc_output(env, ['get_attr', 'stats.hooks_delivered']))
+
+    run_batch('\n'.join([
+        'emit_hook window_title_changed 0x1 foo',
+        'emit_hook window_title_changed 1x0',
+        'emit_hook focus_changed 0x2 bar',
+        'emit_hook window_title_changed',
+        'emit_hook title 0x3 baz',
+    ]), env=env)
+
+    first = int(next_sequence)
+    assert socket_hook(sock) == (first, ['window_title_changed', '0x1', 'foo'])
+    assert socket_hook(sock) == (first + 3, ['window_title_changed'])
+    assert socket_hook(sock) == (first + 4, ['title', '0x3', 'baz'])
+    delivered = int(hc_output(env, ['get_attr', 'stats.hooks_delivered']))
+    assert delivered == delivered_before + 3
+
+
+def test_hook_stream_filter_searches_whole_argument(hlwm_with_socket, socket_connection):
+    env = hlwm_with_socket
+    sock = socket_connection
+    socket_request(sock, ['', 'subscribe', '', 'myhook', 'foo'])
+    status, next_sequence = socket_reply(sock)
+    assert status == 0
+
+    hc_output(env, ['emit_hook', 'myhook', 'bar'])
+    hc_output(env, ['emit_hook', 'myhook', 'a\nfoo'])
+
+    assert socket_hook(sock) == (int(next_sequence) + 1, ['myhook', 'a\nfoo'])
+
+
+def test_hook_stream_closed_on_eof(socket_connection):
+    sock = socket_connection
+    socket_request(sock, ['', 'subscribe', ''])
+    status, _ = socket_reply(sock)
+    assert status == 0
+
+    # the subscriber hangs up, so the server closes the connection
+    # instead of keeping it around for further hooks
+    sock.shutdown(socket.SHUT_WR)
+
+    sock.settimeout(5)
+    assert sock.recv(4096) == b''
+
+
+def test_herbstclient_filter_on_socket(hlwm_with_socket):
+    env = hlwm_with_socket
+    first = int(hc_output(env, ['get_attr', 'stats.hooks_emitted'])) + 1
+    run_batch('emit_hook foo x\nemit_hook bar y\nemit_hook foobar z\n', env=env)
+
+    output = hc_output(env, ['--wait', '--count', '2', '--resume', str(first),
+                             '^foo'])
+
+    assert output == 'foo\tx\nfoobar\tz\n'
+
+
+# the callback types of libherbstclient
+HC_REPLY_CALLBACK = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_char_p,
+                                     ctypes.c_void_p)
+HC_HOOK_CALLBACK = ctypes.CFUNCTYPE(None, ctypes.c_int,
+                                    ctypes.POINTER(ctypes.c_char_p),
+                                    ctypes.c_ulonglong, ctypes.c_void_p)
+
+
+def load_libherbstclient():
+    lib = ctypes.CDLL(LIBHC_PATH)
+    lib.hc_connect_socket.restype = ctypes.c_void_p
+    lib.hc_disconnect.argtypes = [ctypes.c_void_p]
+    lib.hc_fd.argtypes = [ctypes.c_void_p]
+    lib.hc_pending.argtypes = [ctypes.c_void_p]
+    lib.hc_dispatch.argtypes = [ctypes.c_void_p]
+    lib.hc_dispatch.restype = ctypes.c_bool
+    lib.hc_send_command_async.argtypes = [
+        ctypes.c_void_p, ctypes.c_int, ctypes.POINTER(ctypes.c_char_p),
+        HC_REPLY_CALLBACK, ctypes.c_void_p]
+    lib.hc_send_command_async.restype = ctypes.c_bool
+    # the error message is returned as a void pointer such that it can be
+    # freed
+    lib.hc_subscribe_hooks.argtypes = [
+        ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int,
+        ctypes.POINTER(ctypes.c_char_p), ctypes.POINTER(ctypes.c_ulonglong),
+        ctypes.POINTER(ctypes.c_void_p)]
+    lib.hc_subscribe_hooks.restype = ctypes.c_bool
+    lib.hc_set_hook_callback.argtypes = [ctypes.c_void_p, HC_HOOK_CALLBACK,
+                                         ctypes.c_void_p]
+    return lib
+
+
+def test_libherbstclient_async_commands(hlwm_with_socket, monkeypatch):
+    monkeypatch.setenv('XDG_RUNTIME_DIR', hlwm_with_socket['XDG_RUNTIME_DIR'])
+    lib = load_libherbstclient()
+    replies = []
+    callback = HC_REPLY_CALLBACK(lambda status, output, _: replies.append((status, output.decode())))
+    con = lib.hc_connect_socket()
+    assert con
+
+    commands = [['echo', str(i)] if i % 10 else ['get_attr', 'nonexisting']
+                for i in range(1, 51)]
+    for cmd in commands:
+        argv = (ctypes.c_char_p * len(cmd))(*[a.encode() for a in cmd])
+        assert lib.hc_send_command_async(con, len(cmd), argv, callback, None)
+    assert lib.hc_pending(con) == 50
+    while lib.hc_pending(con) > 0:
+        select.select([lib.hc_fd(con)], [], [], 5)
+        assert lib.hc_dispatch(con)
+
+    assert len(replies) == 50
+    for cmd, (status, output) in zip(commands, replies):
+        if cmd[0] == 'echo':
+            assert (status, output) == (0, cmd[1] + '\n')
+        else:
+            assert status != 0
+    lib.hc_disconnect(con)
+
+
+def test_libherbstclient_requests_always_in_flight(hlwm_with_socket, monkeypatch):
+    monkeypatch.setenv('XDG_RUNTIME_DIR', hlwm_with_socket['XDG_RUNTIME_DIR'])
+    lib = load_libherbstclient()
+    con = lib.hc_connect_socket()
+    assert con
+    sent = []
+    replies = []
+
+    def send_next():
+        cmd = ['echo', str(len(sent))]
+        argv = (ctypes.c_char_p * len(cmd))(*[a.encode() for a in cmd])
+        assert lib.hc_send_command_async(con, len(cmd), argv, callback, None)
+        sent.append(cmd[1] + '\n')
+
+    def on_reply(status, output, _):
+        replies.append(output.decode())
+        if len(sent) < 300:
+            send_next()
+
+    callback = HC_REPLY_CALLBACK(on_reply)
+    # keep 5 requests in flight such that the ring buffer wraps around
+    for _ in range(5):
+        send_next()
+    while lib.hc_pending(con) > 0:
+        assert lib.hc_pending(con) <= 5
+        select.select([lib.hc_fd(con)], [], [], 5)
+        assert lib.hc_dispatch(con)
+
+    assert replies == sent
+    lib.hc_disconnect(con)
+
+
+def test_libherbstclient_subscribe_error(hlwm_with_socket, monkeypatch):
+    monkeypatch.setenv('XDG_RUNTIME_DIR', hlwm_with_socket['XDG_RUNTIME_DIR'])
+    lib = load_libherbstclient()
+    libc = ctypes.CDLL(None)
+    con = lib.hc_connect_socket()
+    assert con
+    error = ctypes.c_void_p()
+    hook_filter = (ctypes.c_char_p * 1)(b'(')
+
+    assert not lib.hc_subscribe_hooks(con, None, 1, hook_filter, None, ctypes.byref(error))
+
+    assert 'Cannot parse regex' in ctypes.string_at(error.value).decode()
+    libc.free(error)
+    lib.hc_disconnect(con)
+
+
+def test_libherbstclient_hook_callback(hlwm_with_socket, monkeypatch):
+    monkeypatch.setenv('XDG_RUNTIME_DIR', hlwm_with_socket['XDG_RUNTIME_DIR'])
+    lib = load_libherbstclient()
+    hooks = []
+    callback = HC_HOOK_CALLBACK(lambda argc, argv, sequence, _:
+                                hooks.append((sequence, [argv[i].decode() for i in range(argc)])))
+    con = lib.hc_connect_socket()
+    assert con
+    next_sequence = ctypes.c_ulonglong()
+    hook_filter = (ctypes.c_char_p * 1)(b'^myhook$')
+    assert lib.hc_subscribe_hooks(con, None, 1, hook_filter, ctypes.byref(next_sequence), None)
+    lib.hc_set_hook_callback(con, callback, None)
+
+    run_batch('emit_hook other\nemit_hook myhook a\nemit_hook myhook b\n',
+              env=hlwm_with_socket)
+    while len(hooks) < 2:
+        readable, _, _ = select.select([lib.hc_fd(con)], [], [], 5)
+        assert readable
+        assert lib.hc_dispatch(con)
+
+    first = next_sequence.value
+    assert hooks == [(first + 1, ['myhook', 'a']), (first + 2, ['myhook', 'b'])]
+    lib.hc_disconnect(con)
@@ -1,4 +1,5 @@
 import pytest
+import time
 
 
 def test_emit_hook(hlwm, hc_idle):
@@ -36,3 +37,52 @@ def test_no_fullscreen_hook_if_nothing_changes(hlwm, hc_idle, change):
 
     # a fullscreen hook is fired if and only if a proper change happens
     assert ('fullscreen' in [hook[0] for hook in hc_idle.hooks()]) == change
+
+
+def test_hooks_are_not_coalesced_by_default(hlwm, hc_idle):
+    for title in ['a', 'b', 'c']:
+        hlwm.call(['emit_hook', 'window_title_changed', '0x1', title])
+
+    assert hc_idle.hooks() == [['window_title_changed', '0x1', t] for t in ['a', 'b', 'c']]
+    assert hlwm.attr.stats.hooks_suppressed() == '0'
+
+
+def test_hook_coalescing(hlwm, hc_idle):
+    hlwm.attr.settings.hook_coalesce_ms = 1000
+    hlwm.attr.settings.hook_coalesce_hooks = 'my_flood|other_flood'
+
+    for title in ['t1', 't2', 't3', 't4']:
+        hlwm.call(['emit_hook', 'my_flood', 'win1', title])
+    hlwm.call('emit_hook my_flood win2 x')
+    hlwm.call('emit_hook not_coalesced y')
+    hlwm.call('emit_hook not_coalesced z')
+
+    # the first hook of every window and client is emitted immediately
+    assert hc_idle.hooks() == [
+        ['my_flood', 'win1', 't1'],
+        ['my_flood', 'win2', 'x'],
+        ['not_coalesced', 'y'],
+        ['not_coalesced', 'z'],
+    ]
+    # t2 and t3 are replaced by t4
+    assert hlwm.attr.stats.hooks_suppressed() == '2'
+
+    # and the most recent one is emitted when the window ends
+    time.sleep(1.5)
+    assert hc_idle.hooks() == [['my_flood', 'win1', 't4']]
+    assert hlwm.attr.stats.hooks_suppressed() == '2'
+
+
+def test_hook_coalescing_disabled_meanwhile(hlwm, hc_idle):
+    hlwm.attr.settings.hook_coalesce_ms = 500
+    hlwm.call('emit_hook window_title_changed 0x1 a')
+    hlwm.call('emit_hook window_title_changed 0x1 b')
+    hlwm.attr.settings.hook_coalesce_ms = 0
+    hlwm.call('emit_hook window_title_changed 0x2 c')
+
+    time.sleep(1)
+    assert hc_idle.hooks() == [
+        ['window_title_changed', '0x1', 'a'],
+        ['window_title_changed', '0x2', 'c'],
+        ['window_title_changed', '0x1', 'b'],
+    ]
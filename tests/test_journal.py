@@ -0,0 +1,113 @@
+def changes_since(hlwm, sequence):
+    """return the changes after the given sequence number as a list
+    of tuples (path, old value, new value)"""
+    output = hlwm.call(['attr_changes', str(sequence)]).stdout
+    changes = []
+    for line in output.splitlines():
+        _, path, old_value, new_value = line.split('\t')
+        changes.append((path, old_value, new_value))
+    return changes
+
+
+def test_journal_records_attribute_change(hlwm):
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call('rename default foo')
+
+    assert ('tags.0.name', 'default', 'foo') in changes_since(hlwm, sequence)
+    assert int(hlwm.attr.journal.sequence()) > sequence
+
+
+def test_journal_sequence_numbers(hlwm):
+    sequence = int(hlwm.attr.journal.sequence())
+    hlwm.call('new_attr string tags.my_foo')
+
+    for value in ['a', 'b', 'c']:
+        hlwm.attr.tags.my_foo = value
+
+    output = hlwm.call(['attr_changes', str(sequence)]).stdout
+    lines = [line.split('\t') for line in output.splitlines()]
+    assert [line[0] for line in lines] \
+        == [str(sequence + i) for i in range(1, len(lines) + 1)]
+    assert changes_since(hlwm, sequence + 1) == [
+        ('tags.my_foo', 'a', 'b'),
+        ('tags.my_foo', 'b', 'c'),
+    ]
+    assert changes_since(hlwm, sequence + 3) == []
+
+
+def test_journal_escapes_values(hlwm):
+    hlwm.call('new_attr string monitors.my_foo')
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.attr.monitors.my_foo = 'a\tb\nc'
+
+    output = hlwm.call(['attr_changes', str(sequence)]).stdout
+    assert output == f'{sequence + 1}\tmonitors.my_foo\t\ta\\tb\\nc\n'
+
+
+def test_journal_prefers_canonical_path(hlwm):
+    winid, _ = hlwm.create_client()
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call('set_attr clients.focus.pseudotile on')
+
+    changes = changes_since(hlwm, sequence)
+    assert (f'clients.{winid}.pseudotile', 'false', 'true') in changes
+    assert not [c for c in changes if c[0].startswith('clients.focus.')]
+
+
+def test_journal_follows_tree_changes(hlwm):
+    hlwm.call('add bar')
+    hlwm.call('merge_tag bar')
+    hlwm.call('add baz')
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call('rename baz qux')
+
+    assert ('tags.1.name', 'baz', 'qux') in changes_since(hlwm, sequence)
+
+
+def test_journal_truncated(hlwm):
+    hlwm.call('new_attr int settings.my_foo')
+    hlwm.attr.journal.capacity = 2
+    sequence = int(hlwm.attr.journal.sequence())
+
+    for value in range(1, 4):
+        hlwm.attr.settings.my_foo = value
+
+    hlwm.call_xfail(['attr_changes', str(sequence)]) \
+        .expect_stderr(f'the changes after {sequence} are not available anymore')
+    assert changes_since(hlwm, sequence + 1) == [
+        ('settings.my_foo', '1', '2'),
+        ('settings.my_foo', '2', '3'),
+    ]
+
+
+def test_journal_capacity_zero(hlwm):
+    hlwm.attr.journal.capacity = 0
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call('rename default foo')
+
+    assert int(hlwm.attr.journal.sequence()) == sequence
+    assert changes_since(hlwm, sequence) == []
+
+
+def test_journal_capacity_zero_and_back(hlwm):
+    hlwm.attr.journal.capacity = 0
+    # objects created while the journal is disabled are followed as well
+    hlwm.call('add bar')
+    hlwm.attr.journal.capacity = 10
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call('rename bar baz')
+
+    assert ('tags.1.name', 'bar', 'baz') in changes_since(hlwm, sequence)
+
+
+def test_journal_sequence_from_the_future(hlwm):
+    sequence = int(hlwm.attr.journal.sequence())
+
+    hlwm.call_xfail(['attr_changes', str(sequence + 1)]) \
+        .expect_stderr(f'there are only {sequence} changes')
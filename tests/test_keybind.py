@@ -1,5 +1,6 @@
 import pytest
 import subprocess
+import time
 
 
 @pytest.mark.parametrize('sep', ['-', '+'])
@@ -71,6 +72,18 @@ def test_trigger_single_key_binding(hlwm, keyboard):
     assert hlwm.get_attr('monitors.0.tag') == 'tag2'
 
 
+def test_trigger_replaced_binding_among_many(hlwm, keyboard):
+    for key in 'abcdefghijklmnopqrstuvw':
+        hlwm.call(['keybind', f'Mod1+{key}', 'true'])
+    hlwm.call('keybind x add tag2')
+    hlwm.call('keybind x add tag3')
+    hlwm.call('keyunbind Mod1+a')
+
+    keyboard.press('x')
+
+    assert hlwm.list_children('tags.by-name.') == ['default', 'tag3']
+
+
 def test_trigger_selfremoving_binding(hlwm, keyboard):
     hlwm.call('keybind x keyunbind x')
 
@@ -324,3 +337,216 @@ def test_keybind_unknown_binding(hlwm):
 def test_empty_keysym(hlwm, command):
     hlwm.call_xfail([command, '', 'true']) \
         .expect_stderr('Must not be empty')
+
+
+def test_keymask_refocus_and_rebind(hlwm, keyboard):
+    c1, _ = hlwm.create_client()
+    c2, _ = hlwm.create_client()
+    hlwm.call(f'set_attr clients.{c1}.keymask x')
+    hlwm.call(f'set_attr clients.{c2}.keys_inactive x')
+    hlwm.call('new_attr int my_x_pressed 0')
+    hlwm.call('new_attr int my_y_pressed 0')
+    hlwm.call('keybind x set_attr my_x_pressed +=1')
+
+    # switch between the two keymasks several times; the bindings
+    # allowed for each of them are computed only once
+    for _ in range(2):
+        hlwm.call(f'jumpto {c1}')
+        keyboard.press('x')
+        hlwm.call(f'jumpto {c2}')
+        keyboard.press('x')
+    assert hlwm.get_attr('my_x_pressed') == '2'
+
+    # a new binding must be taken into account for both masks
+    hlwm.call('keybind y set_attr my_y_pressed +=1')
+    keyboard.press('y')
+    hlwm.call(f'jumpto {c1}')
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == '1'
+
+    # after unbinding x, the remaining binding is unaffected
+    hlwm.call('keyunbind x')
+    hlwm.call(f'jumpto {c2}')
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == '2'
+
+
+def test_keymode_chain(hlwm, keyboard):
+    hlwm.call('new_attr string my_y_pressed')
+    hlwm.call('keybind x keymode chain')
+    hlwm.call('keybind --mode=chain y set_attr my_y_pressed pressed')
+    assert hlwm.get_attr('keys.modes.chain.name') == 'chain'
+
+    # y is only bound in the mode
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == ''
+
+    keyboard.press('x')
+    assert hlwm.get_attr('keys.mode') == 'chain'
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == 'pressed'
+    # the mode is not sticky, so the default bindings are active again
+    assert hlwm.get_attr('keys.mode') == ''
+
+
+def test_keymode_disables_default_bindings(hlwm, keyboard):
+    hlwm.call('new_attr int my_x_pressed 0')
+    hlwm.call('keybind x set_attr my_x_pressed +=1')
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call('keymode m')
+
+    keyboard.press('x')
+    assert hlwm.get_attr('my_x_pressed') == '0'
+
+    hlwm.call('keymode')
+    assert hlwm.get_attr('keys.mode') == ''
+    keyboard.press('x')
+    assert hlwm.get_attr('my_x_pressed') == '1'
+
+
+def test_keymode_sticky_and_escape(hlwm, keyboard):
+    hlwm.call('new_attr int my_y_pressed 0')
+    hlwm.call('keybind --mode=m y set_attr my_y_pressed +=1')
+    hlwm.call('set_attr keys.modes.m.sticky on')
+    hlwm.call('keymode m')
+
+    keyboard.press('y')
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == '2'
+    assert hlwm.get_attr('keys.mode') == 'm'
+
+    keyboard.press('Escape')
+    assert hlwm.get_attr('keys.mode') == ''
+    keyboard.press('y')
+    assert hlwm.get_attr('my_y_pressed') == '2'
+
+
+def test_keymode_custom_escape(hlwm, keyboard):
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call_xfail('set_attr keys.modes.m.escape Mod4-') \
+        .expect_stderr('not a valid value')
+    hlwm.call('set_attr keys.modes.m.escape q')
+    hlwm.call('keymode m')
+
+    keyboard.press('Escape')
+    assert hlwm.get_attr('keys.mode') == 'm'
+    keyboard.press('q')
+    assert hlwm.get_attr('keys.mode') == ''
+
+
+def test_keymode_change_escape_while_active(hlwm, keyboard):
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call('keymode m')
+
+    hlwm.call('set_attr keys.modes.m.escape q')
+
+    keyboard.press('Escape')
+    assert hlwm.get_attr('keys.mode') == 'm'
+    keyboard.press('q')
+    assert hlwm.get_attr('keys.mode') == ''
+
+
+def test_keymode_change_timeout_while_active(hlwm):
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call('keymode m')
+
+    hlwm.call('set_attr keys.modes.m.timeout 100')
+    time.sleep(0.3)
+
+    assert hlwm.get_attr('keys.mode') == ''
+
+
+def test_keymode_timeout(hlwm):
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call('set_attr keys.modes.m.timeout 100')
+    hlwm.call('keymode m')
+    assert hlwm.get_attr('keys.mode') == 'm'
+
+    time.sleep(0.3)
+
+    assert hlwm.get_attr('keys.mode') == ''
+
+
+def test_keymode_list_and_unbind(hlwm):
+    hlwm.call('keybind x true')
+    hlwm.call('keybind --mode=m y true')
+    hlwm.call('keybind --mode=m z false')
+
+    assert hlwm.call('list_keybinds').stdout == 'x\ttrue\n'
+    assert hlwm.call('list_keybinds --mode=m').stdout == 'y\ttrue\nz\tfalse\n'
+
+    hlwm.call('keyunbind --mode=m z')
+    assert hlwm.call('list_keybinds --mode=m').stdout == 'y\ttrue\n'
+
+    hlwm.call('keymode m')
+    # removing all bindings of a mode removes the mode
+    hlwm.call('keyunbind --mode=m --all')
+    assert hlwm.get_attr('keys.mode') == ''
+    assert 'm' not in hlwm.list_children('keys.modes')
+    hlwm.call_xfail('keymode m') \
+        .expect_stderr('there is no key mode "m"')
+    hlwm.call_xfail('list_keybinds --mode=m') \
+        .expect_stderr('there is no key mode "m"')
+    assert hlwm.call('list_keybinds').stdout == 'x\ttrue\n'
+
+
+@pytest.mark.parametrize('command', [
+    'keyunbind --mode=typo x',
+    'keyunbind --mode=typo --all',
+    'list_keybinds --mode=typo',
+])
+def test_keymode_only_created_by_keybind(hlwm, command):
+    hlwm.call_xfail(command) \
+        .expect_stderr('there is no key mode "typo"')
+
+    assert 'typo' not in hlwm.list_children('keys.modes')
+
+
+def test_keymode_complete(hlwm):
+    hlwm.call('keybind --mode=m y true')
+    assert hlwm.complete('keymode') == ['m']
+    assert '--mode=m' in hlwm.complete('keybind')
+    assert hlwm.complete('keyunbind --mode=m') == sorted(['-F', '--all', 'y'])
+
+
+def test_keymask_more_masks_than_cached(hlwm, keyboard):
+    # more distinct keymasks than the number of cached ones
+    keys = ['a', 'b', 'c', 'd', 'e', 'f']
+    clients = []
+    for k in keys:
+        winid, _ = hlwm.create_client()
+        hlwm.call(f'set_attr clients.{winid}.keymask {k}')
+        hlwm.call(f'new_attr int my_{k}_pressed 0')
+        hlwm.call(f'keybind {k} set_attr my_{k}_pressed +=1')
+        clients.append(winid)
+
+    for _ in range(2):
+        for winid in clients:
+            hlwm.call(f'jumpto {winid}')
+            for k in keys:
+                keyboard.press(k)
+
+    # only the key allowed by the keymask of the focused client was grabbed
+    for k in keys:
+        assert hlwm.get_attr(f'my_{k}_pressed') == '2'
+
+
+def test_keybinding_sees_focus_of_previous_binding(hlwm, keyboard):
+    hlwm.call('split horizontal')
+    winid_left, proc_left = hlwm.create_client()
+    hlwm.call('focus right')
+    winid_right, proc_right = hlwm.create_client()
+    hlwm.call('focus left')
+    hlwm.call('keybind x focus right')
+    hlwm.call('keybind y close')
+
+    # both key presses are possibly handled in the same batch of events
+    keyboard.press('x')
+    keyboard.press('y')
+
+    proc_right.wait(10)  # wait for the client to shut down
+    hlwm.call('true')  # sync with hlwm
+    clients = hlwm.list_children('clients')
+    assert winid_right not in clients
+    assert winid_left in clients
+    assert proc_left.poll() is None
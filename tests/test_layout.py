@@ -771,6 +771,79 @@ def test_split_and_remove_with_smart_frame_surroundings(hlwm, x11, align):
     assert (frame_geom.width, frame_geom.height) == (800, 600)
 
 
+def test_chain_of_layout_changes_final_geometry(hlwm, x11):
+    hlwm.call('set smart_frame_surroundings on')
+    hlwm.call('chain , split horizontal , split vertical , remove , remove')
+
+    frame_geom = x11.get_hlwm_frames()[0].get_geometry()
+    assert (frame_geom.width, frame_geom.height) == (800, 600)
+
+
+def test_chain_of_layout_changes_applied_once_done(hlwm):
+    hlwm.create_client()
+    relayouts = int(hlwm.get_attr('stats.relayouts'))
+
+    hlwm.call('chain , split horizontal , split vertical , remove , remove')
+
+    assert int(hlwm.get_attr('stats.relayouts')) == relayouts + 1
+
+
+def test_chain_relayouts_only_before_reading_the_layout(hlwm):
+    winid, _ = hlwm.create_client()
+    relayouts = int(hlwm.get_attr('stats.relayouts'))
+
+    hlwm.call(['chain', ',', 'split', 'horizontal', ',', 'split', 'vertical',
+               ',', 'get_attr', f'clients.{winid}.content_geometry',
+               ',', 'remove', ',', 'remove'])
+
+    # once for 'get_attr' and once after the chain
+    assert int(hlwm.get_attr('stats.relayouts')) == relayouts + 2
+
+
+def test_chain_sees_focus_of_previous_command(hlwm):
+    hlwm.call('split horizontal')
+    winid_left, _ = hlwm.create_client()
+    hlwm.call('focus right')
+    winid_right, _ = hlwm.create_client()
+    hlwm.call('focus left')
+    assert hlwm.get_attr('clients.focus.winid') == winid_left
+
+    output = hlwm.call('chain , focus right , get_attr clients.focus.winid').stdout
+
+    assert output == winid_right
+
+    hlwm.call('chain , focus left , set_attr clients.focus.fullscreen on')
+
+    assert hlwm.get_attr(f'clients.{winid_left}.fullscreen') == 'true'
+    assert hlwm.get_attr(f'clients.{winid_right}.fullscreen') == 'false'
+
+
+def test_chain_sees_geometry_of_previous_command(hlwm):
+    winid, _ = hlwm.create_client()
+    old_geometry = hlwm.get_attr(f'clients.{winid}.content_geometry')
+
+    output = hlwm.call(['chain', ',', 'split', 'horizontal',
+                        ',', 'get_attr', f'clients.{winid}.content_geometry'])
+
+    assert output.stdout != old_geometry
+    assert output.stdout == hlwm.get_attr(f'clients.{winid}.content_geometry')
+
+
+def test_relayout_deferred_while_locked(hlwm, x11):
+    winhandle, winid = x11.create_client()
+    hlwm.call('lock')
+    hlwm.call('split explode')
+    x11.sync_with_hlwm()
+    geom = x11.get_absolute_geometry(winhandle)
+    # the client still fills the entire monitor
+    assert geom.width > 400
+
+    hlwm.call('unlock')
+
+    geom = x11.get_absolute_geometry(winhandle)
+    assert geom.width < 400
+
+
 @pytest.mark.parametrize("client_focused", list(range(0, 4)))
 @pytest.mark.parametrize("direction", ['u', 'd', 'l', 'r'])
 def test_focus_directional_2x2grid(hlwm, client_focused, direction):
@@ -1778,3 +1851,126 @@ def test_frame_leaf_algorithm_change(hlwm, x11):
     assert geom1_before.height < geom1_now.height
     assert geom1_now.width == geom2_now.width
     assert geom1_now.height == geom2_now.height
+
+
+def client_geometries(hlwm, winids):
+    return [hlwm.get_attr(f'clients.{winid}.content_geometry') for winid in winids]
+
+
+def assert_layout_is_fresh(hlwm, winids):
+    """assert that the clients have the geometries of a layout that is
+    computed from scratch. Loading the dumped layout again marks every frame
+    of the tag as modified, so none of the cached layouts is used.
+    """
+    geometries = client_geometries(hlwm, winids)
+    hlwm.call(['load', hlwm.call('dump').stdout])
+    assert client_geometries(hlwm, winids) == geometries
+
+
+@pytest.mark.parametrize('layout,setting,value', [
+    ('grid', 'frame_gap', '12'),
+    ('grid', 'frame_padding', '7'),
+    ('grid', 'window_gap', '9'),
+    ('grid', 'frame_border_width', '6'),
+    ('grid', 'gapless_grid', 'off'),
+    ('grid', 'smart_frame_surroundings', 'on'),
+    ('max', 'smart_window_surroundings', 'on'),
+])
+def test_layout_setting_updates_cached_layout(hlwm, x11, layout, setting, value):
+    hlwm.call('set window_gap 4')
+    hlwm.call(['set_layout', layout])
+    winids = [x11.create_client()[1] for _ in range(0, 3)]
+    before = client_geometries(hlwm, winids)
+
+    hlwm.call(['set', setting, value])
+
+    assert client_geometries(hlwm, winids) != before
+    assert_layout_is_fresh(hlwm, winids)
+
+
+def test_pseudotile_in_max_frame_updates_cached_layout(hlwm, x11):
+    hlwm.call('set_layout max')
+    hlwm.call('set hide_covered_windows on')
+    win1, winid1 = x11.create_client()
+    win2, winid2 = x11.create_client()
+    hlwm.call(['jumpto', winid1])
+
+    hlwm.attr.clients[winid1].pseudotile = hlwm.bool(True)
+
+    x11.sync_with_hlwm()
+    geom1 = x11.get_absolute_geometry(win1)
+    geom2 = x11.get_absolute_geometry(win2)
+    # the client below the pseudotiled one is not covered anymore
+    assert geom1.width < geom2.width
+    assert geom2.x > 0 and geom2.y > 0
+    assert_layout_is_fresh(hlwm, [winid1, winid2])
+
+    hlwm.attr.clients[winid1].pseudotile = hlwm.bool(False)
+
+    x11.sync_with_hlwm()
+    geom1 = x11.get_absolute_geometry(win1)
+    geom2 = x11.get_absolute_geometry(win2)
+    assert geom1.width == geom2.width
+    assert geom2.x + geom2.width <= 0
+    assert_layout_is_fresh(hlwm, [winid1, winid2])
+
+
+@pytest.mark.parametrize('command', [
+    ['rotate'],
+    ['mirror', 'horizontal'],
+    ['mirror', 'vertical'],
+    ['mirror', 'both'],
+])
+def test_rotate_and_mirror_update_cached_layout(hlwm, x11, command):
+    winids = [x11.create_client()[1] for _ in range(0, 3)]
+    hlwm.call(['load', f"""
+        (split horizontal:0.3:0
+          (split vertical:0.4:0
+            (clients vertical:0 {winids[0]})
+            (clients vertical:0 {winids[1]}))
+          (clients vertical:0 {winids[2]}))
+    """])
+    before = client_geometries(hlwm, winids)
+
+    hlwm.call(command)
+
+    assert client_geometries(hlwm, winids) != before
+    assert_layout_is_fresh(hlwm, winids)
+
+
+@pytest.mark.parametrize('layout_a,layout_b', [
+    ('(split horizontal:0.3:0 (clients vertical:0 {0}) (clients vertical:0 {1}))',
+     '(split horizontal:0.6:0 (clients vertical:0 {0}) (clients vertical:0 {1}))'),
+    ('(clients vertical:0 {0} {1})',
+     '(clients horizontal:0 {0} {1})'),
+])
+def test_load_updates_cached_layout(hlwm, x11, layout_a, layout_b):
+    winids = [x11.create_client()[1] for _ in range(0, 2)]
+    hlwm.call(['load', layout_a.format(*winids)])
+    geometries_a = client_geometries(hlwm, winids)
+
+    hlwm.call(['load', layout_b.format(*winids)])
+    assert client_geometries(hlwm, winids) != geometries_a
+
+    hlwm.call(['load', layout_a.format(*winids)])
+    assert client_geometries(hlwm, winids) == geometries_a
+
+
+@pytest.mark.parametrize('command', [['cycle'], ['cycle', '-1'], ['jumpto']])
+def test_selection_change_updates_cached_layout(hlwm, x11, command):
+    hlwm.call('set_layout max')
+    hlwm.call('set hide_covered_windows on')
+    clients = [x11.create_client() for _ in range(0, 3)]
+    focus_before = hlwm.get_attr('clients.focus.winid')
+    if command == ['jumpto']:
+        command = ['jumpto', next(winid for _, winid in clients if winid != focus_before)]
+
+    hlwm.call(command)
+
+    focus = hlwm.get_attr('clients.focus.winid')
+    assert focus != focus_before
+    x11.sync_with_hlwm()
+    # only the selected client of the max frame is on the screen
+    for win, winid in clients:
+        geom = x11.get_absolute_geometry(win)
+        assert (geom.x + geom.width > 0) == (winid == focus)
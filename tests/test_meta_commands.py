@@ -289,6 +289,41 @@ def test_remove_attr_user_attribute(hlwm):
     hlwm.call(['new_attr', 'string', path])  # and is free again
 
 
+def test_attribute_paths_follow_tree_changes(hlwm):
+    # read the paths before and after the object tree changes, such that
+    # they are resolved again
+    hlwm.call_xfail('get_attr tags.1.name') \
+        .expect_stderr('No such object tags.1')
+    assert hlwm.get_attr('tags.focus.name') == 'default'
+
+    hlwm.call('add othertag')
+    assert hlwm.get_attr('tags.1.name') == 'othertag'
+    hlwm.call('use_index 1')
+    assert hlwm.get_attr('tags.focus.name') == 'othertag'
+    hlwm.attr.tags[1].name = 'renamed'
+    assert hlwm.get_attr('tags.by-name.renamed.index') == '1'
+
+    hlwm.call('use_index 0')
+    hlwm.call('merge_tag renamed')
+    hlwm.call_xfail('get_attr tags.1.name') \
+        .expect_stderr('No such object tags.1')
+    hlwm.call_xfail('get_attr tags.by-name.renamed.index')
+    assert hlwm.get_attr('tags.focus.name') == 'default'
+
+
+def test_attribute_paths_follow_user_attributes(hlwm):
+    hlwm.call('compare tags.count = 1')
+    hlwm.call_xfail('compare tags.my_attr = foo') \
+        .expect_stderr('has no attribute "my_attr"')
+
+    hlwm.call('new_attr string tags.my_attr foo')
+    hlwm.call('compare tags.my_attr = foo')
+    hlwm.call('remove_attr tags.my_attr')
+
+    hlwm.call_xfail('compare tags.my_attr = foo') \
+        .expect_stderr('has no attribute "my_attr"')
+
+
 def test_getenv_completion(hlwm):
     prefix = 'some_uniq_prefix_'
     name = prefix + 'envname'
@@ -656,6 +691,42 @@ def test_foreach_object_completion(hlwm):
     assert 'tags.count' not in completions
 
 
+def test_dump_attr_matches_get_attr(hlwm):
+    hlwm.create_clients(2)
+    hlwm.call('add othertag')
+
+    lines = hlwm.call('dump_attr').stdout.splitlines()
+
+    attributes = {}
+    for line in lines:
+        path, typechar, flags, value = line.split('\t')
+        attributes[path] = (typechar, flags, value)
+    assert len(attributes) == len(lines)
+    for path, (typechar, flags, value) in attributes.items():
+        assert hlwm.get_attr(path) == value
+    assert attributes['tags.1.name'] == ('s', 'wh', 'othertag')
+    assert attributes['tags.count'] == ('u', '--', '2')
+    assert 'clients.focus.winid' in attributes
+
+
+def test_dump_attr_subtree(hlwm):
+    winid, _ = hlwm.create_client()
+    hlwm.call(['new_attr', 'string', 'clients.{}.my_text'.format(winid),
+               'a\tb\\c\nd'])
+
+    lines = hlwm.call(['dump_attr', 'clients.' + winid + '.']).stdout.splitlines()
+
+    assert lines
+    assert all(line.startswith('clients.' + winid + '.') for line in lines)
+    prefix = 'clients.{}.my_text\t'.format(winid)
+    assert prefix + 's\twh\ta\\tb\\\\c\\nd' in lines
+
+
+def test_dump_attr_invalid_object(hlwm):
+    hlwm.call_xfail('dump_attr clients.foobar') \
+        .expect_stderr('"clients." has no child named "foobar"')
+
+
 def test_foreach_identfier_completion(hlwm):
     # the identfier isn't completed in the object parameter
     assert 'X ' not in hlwm.complete(['foreach', 'X', ], partial=True)
@@ -86,3 +86,45 @@ def test_chain_commands_if_then_else(hlwm, value):
     output = hlwm.call(cmd).stdout
 
     assert output == expected
+
+
+@pytest.mark.parametrize('hlwm_process', [{'socket': v} for v in [True, False]], indirect=True)
+def test_call_many(hlwm):
+    procs = hlwm.call_many([
+        'echo foo',
+        ['add', 'newtag'],
+        ['get_attr', 'tags.count'],
+    ])
+
+    assert [p.stdout for p in procs] == ['foo\n', '', '2']
+
+
+@pytest.mark.parametrize('hlwm_process', [{'socket': True}], indirect=True)
+def test_persistent_connection(hlwm):
+    hlwm.call('true')
+    connection = hlwm.connection
+    assert connection is not None
+
+    hlwm.attr.my_attr = 'value'
+
+    assert hlwm.attr.my_attr() == 'value'
+    assert hlwm.connection is connection
+
+
+@pytest.mark.parametrize('hlwm_process', [{'socket': True}], indirect=True)
+@pytest.mark.parametrize('command', [
+    ['echo', 'foo'],
+    ['get_attr', 'does_not_exist'],
+    ['set_attr'],
+    ['no_such_command'],
+])
+def test_persistent_connection_like_herbstclient(hlwm, command):
+    proc = hlwm.unchecked_call(command)
+    assert hlwm.connection is not None
+
+    expected = subprocess.run([hlwm.herbstclient_path, '-n'] + command,
+                              stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                              env=hlwm.env, universal_newlines=True)
+    assert proc.returncode == expected.returncode
+    assert proc.stdout == expected.stdout
+    assert proc.stderr == expected.stderr
@@ -1,5 +1,7 @@
 import pytest
 import re
+import time
+from Xlib import Xatom
 from herbstluftwm.types import Rectangle
 
 
@@ -302,7 +304,6 @@ def test_condition_maxage(hlwm):
     hlwm.call('add tag2')
 
     hlwm.call('rule maxage=1 tag=tag2')
-    import time
     time.sleep(2)
     winid, _ = hlwm.create_client()
 
@@ -318,6 +319,22 @@ def test_condition_numeric_equal(hlwm):
     assert hlwm.get_attr('clients', winid, 'tag') == 'tag2'
 
 
+@pytest.mark.parametrize('pattern,matches', [
+    ('.*foo', True),
+    ('a.foo', True),
+    ('a', False),
+])
+def test_condition_regexp_match_multiline_title(hlwm, x11, pattern, matches):
+    hlwm.call('add tag2')
+    hlwm.call(['rule', 'title~' + pattern, 'tag=tag2'])
+
+    _, winid = x11.create_client(pre_map=lambda w: w.set_wm_name('a\nfoo'))
+
+    assert hlwm.get_attr('clients', winid, 'title') == 'a\nfoo'
+    expected_tag = 'tag2' if matches else 'default'
+    assert hlwm.get_attr('clients', winid, 'tag') == expected_tag
+
+
 def test_condition_instance(hlwm):
     hlwm.call('add tag2')
 
@@ -974,3 +991,81 @@ def test_smart_placement_within_monitor(hlwm):
     # is still within the monitor
     assert inner_geometry.x - bw >= 0
     assert inner_geometry.y - bw >= 0
+
+
+def test_rule_evaluation_needs_no_atom_round_trips(hlwm, x11):
+    hlwm.call('rule windowrole=foo class=bar windowtype=_NET_WM_WINDOW_TYPE_DIALOG tag=baz')
+    hlwm.call('rule pid=1234 instance=qux pseudotile=on')
+    misses = hlwm.attr.stats.atom_cache_misses()
+
+    x11.create_client()
+
+    assert hlwm.attr.stats.atom_cache_misses() == misses
+
+
+def test_rule_conditions_on_prefetched_properties(hlwm, x11):
+    hlwm.call('add othertag')
+    hlwm.call(['rule', 'class=myclass', 'instance=myinst', 'windowrole=myrole',
+               'windowtype=_NET_WM_WINDOW_TYPE_DIALOG', 'pid=4321',
+               'title=Some Window', 'tag=othertag'])
+
+    def set_role(win):
+        win.change_property(x11.display.intern_atom('WM_WINDOW_ROLE'),
+                            Xatom.STRING, 8, b'myrole')
+
+    _, winid = x11.create_client(wm_class=('myinst', 'myclass'),
+                                 window_type='_NET_WM_WINDOW_TYPE_DIALOG',
+                                 pid=4321, pre_map=set_role)
+
+    assert hlwm.get_attr(f'clients.{winid}.tag') == 'othertag'
+    assert hlwm.get_attr(f'clients.{winid}.pid') == '4321'
+    assert hlwm.get_attr(f'clients.{winid}.title') == 'Some Window'
+    assert hlwm.get_attr(f'clients.{winid}.floating') == 'true'
+
+
+def test_indexed_and_unindexed_rules_keep_their_order(hlwm, x11):
+    for tag in ['t1', 't2', 't3', 't4']:
+        hlwm.call(['add', tag])
+    hlwm.call('rule class=myclass tag=t1')
+    hlwm.call('rule title~.* tag=t2')
+    hlwm.call('rule instance=myinst tag=t3')
+    hlwm.call('rule prepend class=myclass tag=t4')
+    hlwm.call('rule class=otherclass tag=t4')
+
+    _, winid = x11.create_client(wm_class=('myinst', 'myclass'))
+
+    assert hlwm.get_attr(f'clients.{winid}.tag') == 't3'
+
+
+def test_indexed_once_rule_expires(hlwm, x11):
+    hlwm.call('add t1')
+    hlwm.call('rule once class=myclass tag=t1')
+    hlwm.call('rule class=otherclass tag=t1')
+
+    x11.create_client(wm_class=('myinst', 'otherclass'))
+    assert hlwm.call('list_rules').stdout.count('\n') == 2
+    x11.create_client(wm_class=('myinst', 'myclass'))
+
+    assert hlwm.call('list_rules').stdout == \
+        'label=1\tclass=otherclass\ttag=t1\t\n'
+
+
+def test_indexed_rule_with_maxage_expires(hlwm, x11):
+    hlwm.call('rule class=myclass maxage=0 tag=t1')
+    # the age is measured in whole seconds
+    time.sleep(1.1)
+
+    x11.create_client(wm_class=('myinst', 'otherclass'))
+
+    assert hlwm.call('list_rules').stdout == ''
+
+
+def test_condition_empty_regex_matches_empty_string(hlwm, x11):
+    hlwm.call('add tag2')
+    hlwm.call('rule class~ tag=tag2')
+
+    _, without_class = x11.create_client(wm_class=None)
+    _, with_class = x11.create_client(wm_class=('myinst', 'myclass'))
+
+    assert hlwm.get_attr(f'clients.{without_class}.tag') == 'tag2'
+    assert hlwm.get_attr(f'clients.{with_class}.tag') == 'default'
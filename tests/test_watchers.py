@@ -62,3 +62,35 @@ def test_watchers_custom_attribute_remove(hlwm, hc_idle):
 
     expected_hook = ['attribute_changed', 'monitors.my_var', '-37', '']
     assert hc_idle.hooks() == [expected_hook]
+
+
+def test_watchers_object_on_path_removed(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.1.name')
+
+    hlwm.call('merge_tag foo')
+
+    expected_hook = ['attribute_changed', 'tags.1.name', 'foo', '']
+    assert expected_hook in hc_idle.hooks()
+
+
+def test_watchers_dynamic_child_changes(hlwm, hc_idle):
+    c1, _ = hlwm.create_client()
+    c2, _ = hlwm.create_client()
+    hlwm.call(f'set_attr clients.{c1}.pseudotile on')
+    hlwm.call(f'jumpto {c2}')
+    attr = 'clients.focus.pseudotile'
+    hlwm.call(['watch', attr])
+
+    # the path now leads to a different client
+    hlwm.call(f'jumpto {c1}')
+    # the attribute of the focused client changes
+    hlwm.call('set_attr clients.focus.pseudotile off')
+    # an unrelated change
+    hlwm.call(f'set_attr clients.{c2}.pseudotile on')
+
+    hooks = [h for h in hc_idle.hooks() if h[0] == 'attribute_changed']
+    assert hooks == [
+        ['attribute_changed', attr, 'false', 'true'],
+        ['attribute_changed', attr, 'true', 'false'],
+    ]